@@ -0,0 +1,245 @@
+/*
+ diamond_bench measures every stage of the engine on its own and end to end.
+
+   diamond_bench [--min-time SECONDS] [--max-cells N] [--filter TEXT] [--json FILE]
+
+ grid sizes go from 3 to 4095 (3, 7, 15, ... 2^k - 1), end to end runs cover 1 to 10 rounds.
+ end to end cases whose last grid would hold more than --max-cells cells are skipped.
+ every case is repeated until it ran for --min-time seconds and reports ns/op, bytes/s
+ (message bytes in) and cells/s (grid cells touched). --json writes the same results
+ as JSON so two builds can be compared.
+ */
+
+#include "Cycle.hpp"
+#include "Decryptor.hpp"
+#include "DiamondGeometry.hpp"
+#include "Encryptor.hpp"
+#include "Grid.hpp"
+#include "GridView.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+  struct Result {
+    std::string name;
+    int gridSize;
+    int rounds;
+    std::uint64_t iterations;
+    double nsPerOp;
+    double bytesPerSecond;
+    double cellsPerSecond;
+  };
+
+  struct Options {
+    double minTime = 0.1;
+    std::uint64_t maxCells = std::uint64_t{1} << 26;
+    std::string filter;
+    std::string jsonPath;
+  };
+
+  // keeps the optimizer from dropping work whose result is never used
+  template <typename T>
+  void keep(T const& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+  }
+
+  constexpr const char* layoutName() {
+    switch (Grid::layout) {
+      case GridLayout::ColumnMajor: return "ColumnMajor";
+      case GridLayout::RowMajor: return "RowMajor";
+    }
+    return "";
+  }
+
+  // text with spaces and punctuation, so prepareMessage has something to strip
+  std::string sampleText(const std::size_t letters) {
+    static constexpr std::string_view words = "the quick brown fox, jumps over the lazy dog! ";
+    std::string text;
+    text.reserve(letters * 2);
+    std::size_t kept = 0;
+    for (std::size_t i = 0; kept < letters; ++i) {
+      const char c = words[i % words.size()];
+      text += c;
+      if (c >= 'a' && c <= 'z') ++kept;
+    }
+    return text + '.';
+  }
+
+  class Bench {
+  public:
+    explicit Bench(Options options) : options{std::move(options)} {}
+
+    // runs op until minTime has passed. bytes and cells are what one op processes
+    void run(const std::string& name, const int gridSize, const int rounds,
+             const double bytes, const double cells, const std::function<void()>& op) {
+      if (!options.filter.empty() && name.find(options.filter) == std::string::npos) return;
+      using Clock = std::chrono::steady_clock;
+      op(); // warm up caches and plans
+
+      std::uint64_t iterations = 0;
+      std::uint64_t batch = 1;
+      double elapsed = 0;
+      while (elapsed < options.minTime) {
+        const auto start = Clock::now();
+        for (std::uint64_t i = 0; i < batch; ++i) op();
+        elapsed += std::chrono::duration<double>(Clock::now() - start).count();
+        iterations += batch;
+        batch *= 2;
+      }
+      const double seconds = elapsed / static_cast<double>(iterations);
+      results.push_back({name, gridSize, rounds, iterations, seconds * 1e9, bytes / seconds, cells / seconds});
+
+      const Result& r = results.back();
+      std::cout << std::left << std::setw(24) << r.name << std::right
+                << " n=" << std::setw(4) << r.gridSize << " r=" << std::setw(2) << r.rounds
+                << std::setw(14) << std::fixed << std::setprecision(1) << r.nsPerOp << " ns/op"
+                << std::setw(12) << std::setprecision(2) << r.bytesPerSecond / 1e6 << " MB/s"
+                << std::setw(12) << r.cellsPerSecond / 1e6 << " Mcells/s\n";
+    }
+
+    void writeJson() const {
+      if (options.jsonPath.empty()) return;
+      std::ofstream out(options.jsonPath);
+      if (!out) throw std::runtime_error("cannot write " + options.jsonPath);
+      out << "{\n  \"layout\": \"" << layoutName() << "\",\n"
+          << "  \"min_time\": " << options.minTime << ",\n  \"benchmarks\": [\n";
+      for (std::size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        out << "    {\"name\": \"" << r.name << "\", \"grid_size\": " << r.gridSize << ", \"rounds\": " << r.rounds
+            << ", \"iterations\": " << r.iterations << std::setprecision(17)
+            << ", \"ns_per_op\": " << r.nsPerOp << ", \"bytes_per_second\": " << r.bytesPerSecond
+            << ", \"cells_per_second\": " << r.cellsPerSecond << "}" << (i + 1 < results.size() ? "," : "") << '\n';
+      }
+      out << "  ]\n}\n";
+    }
+
+    [[nodiscard]] const Options& getOptions() const { return options; }
+
+  private:
+    Options options;
+    std::vector<Result> results;
+  };
+
+  void benchStages(Bench& bench, const int size) {
+    const double cells = static_cast<double>(size) * size;
+    const std::string raw = sampleText(DiamondGeometry::capacity(size) - 1);
+    const std::string message = Encryptor::prepareMessage(raw);
+    XoshiroPadding padding(1);
+
+    bench.run("prepareMessage", size, 1, static_cast<double>(raw.size()), cells, [&] {
+      keep(Encryptor::prepareMessage(raw));
+    });
+
+    Grid grid(size);
+    bench.run("Cycle::getDiamondPath", size, 1, static_cast<double>(message.size()), cells, [&] {
+      for (int layer = 0; layer <= size / 2; ++layer) keep(Cycle(&grid, layer).getDiamondPath());
+    });
+
+    bench.run("Cycle::fillWithMessage", size, 1, static_cast<double>(message.size()), cells, [&] {
+      int msgIndex = 0;
+      for (int layer = 0; layer <= size / 2; ++layer) Cycle(&grid, layer, &padding).fillWithMessage(message, msgIndex);
+      keep(grid);
+    });
+
+    // the diamond is filled, the corners are still blank. every op restores that state first
+    Grid blank(size);
+    int msgIndex = 0;
+    for (int layer = 0; layer <= size / 2; ++layer) Cycle(&blank, layer, &padding).fillWithMessage(message, msgIndex);
+    bench.run("fillEmptyCells", size, 1, static_cast<double>(message.size()), cells, [&] {
+      grid = blank;
+      Cycle(&grid, 0, &padding).fillEmptyCells();
+      keep(grid);
+    });
+
+    const std::string encrypted = grid.getEncryptedMessage();
+    bench.run("Grid::getEncryptedMessage", size, 1, cells, cells, [&] {
+      keep(grid.getEncryptedMessage());
+    });
+
+    bench.run("fillColumnByColumn", size, 1, cells, cells, [&] {
+      grid.fillColumnByColumn(encrypted);
+      keep(grid);
+    });
+
+    std::string extracted;
+    bench.run("GridView::extractDiamond", size, 1, cells, cells, [&] {
+      GridView(encrypted).extractDiamond(extracted);
+      keep(extracted);
+    });
+  }
+
+  void benchEndToEnd(Bench& bench, const int size, const int rounds) {
+    const std::string raw = sampleText(DiamondGeometry::capacity(size) - 1);
+    const std::uint64_t length = Encryptor::preparedLength(raw);
+    if (DiamondGeometry::encryptedLength(length, rounds) > bench.getOptions().maxCells) return;
+
+    double cells = 0; // every grid the message passes through
+    std::uint64_t roundLength = length;
+    for (int round = 0; round < rounds; ++round) {
+      roundLength = DiamondGeometry::encryptedLength(roundLength, 1);
+      cells += static_cast<double>(roundLength);
+    }
+
+    Encryptor encryptor(0, rounds);
+    encryptor.setPaddingSeed(1);
+    const std::string encrypted = encryptor.encrypt(raw);
+    bench.run("encrypt", size, rounds, static_cast<double>(raw.size()), cells, [&] {
+      keep(encryptor.encrypt(raw));
+    });
+
+    const Decryptor decryptor(rounds);
+    bench.run("decrypt", size, rounds, static_cast<double>(encrypted.size()), cells, [&] {
+      keep(decryptor.decrypt(encrypted));
+    });
+  }
+
+  int usage() {
+    std::cerr << "usage: diamond_bench [--min-time SECONDS] [--max-cells N] [--filter TEXT] [--json FILE]\n";
+    return 2;
+  }
+}
+
+int main(const int argc, char* argv[]) {
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (i + 1 >= argc) return usage();
+    const std::string value = argv[++i];
+    try {
+      if (arg == "--min-time") options.minTime = std::stod(value);
+      else if (arg == "--max-cells") options.maxCells = std::stoull(value);
+      else if (arg == "--filter") options.filter = value;
+      else if (arg == "--json") options.jsonPath = value;
+      else return usage();
+    } catch (const std::exception&) {
+      return usage();
+    }
+  }
+
+  try {
+    Bench bench(options);
+    for (int size = 3; size <= 4095; size = size * 2 + 1) benchStages(bench, size);
+    for (int size = 3; size <= 4095; size = size * 2 + 1) {
+      for (int rounds = 1; rounds <= 10; ++rounds) benchEndToEnd(bench, size, rounds);
+    }
+    bench.writeJson();
+  } catch (const std::exception& e) {
+    std::cerr << "error: " << e.what() << '\n';
+    return 1;
+  }
+  return 0;
+}
@@ -5,8 +5,43 @@
 #include <limits>
 #include "../diamond_algorithm/Encryptor.hpp"
 #include "../diamond_algorithm/Decryptor.hpp"
+#include "../diamond_algorithm/JobPlanner.hpp"
 #include <utility>
 
+namespace {
+// one line summary of a planned job, sizes in MB
+void printPlan(const JobPlan& plan) {
+    if (plan.overflow) {
+        std::cout << "This job is too large to run at all (the length outgrows 64 bits).\n";
+        return;
+    }
+    constexpr double mb = 1024.0 * 1024.0;
+    std::cout << "Planned: " << plan.rounds.size() << " rounds, output " << plan.outputLength << " chars, peak memory "
+              << static_cast<double>(plan.peakMemory) / mb << " MB, about " << plan.estimatedSeconds << " s\n";
+}
+
+// checks the cost of a job before any of it runs, prints the plan and returns false when it is over the budget
+bool withinBudget(const Interface& app, const JobPlan& plan) {
+    if (plan.fits(app.sessionData.memoryBudget)) return true;
+    printPlan(plan);
+    std::cout << "That is over the memory budget of " << (app.sessionData.memoryBudget >> 20)
+              << " MB. Use fewer rounds or a smaller message.\n";
+    return false;
+}
+
+// the session's Stats when they are switched on, nullptr (nothing measured) otherwise
+Stats* sessionStats(Interface& app) {
+    return app.sessionData.collectStats ? &app.sessionData.stats : nullptr;
+}
+
+void printStats(const Interface& app) {
+    if (!app.sessionData.collectStats) return;
+    std::cout << "Stats: ";
+    app.sessionData.stats.writeJson(std::cout);
+    std::cout << "\n";
+}
+}
+
 // navigation Actions
 NavigateAction::NavigateAction(std::shared_ptr<Menu> target) : targetMenu(std::move(target)) {}
 
@@ -61,6 +96,7 @@ SetGridSizeAction::SetGridSizeAction(const bool autoSize) : automatic(autoSize)
 void SetGridSizeAction::execute(Interface& app) {
     if (automatic) {
         app.sessionData.autoGridSize = true;
+        app.sessionData.gridSize = 0; // what the encryption actions pass on, 0 = automatic
         std::cout << "Grid size will be calculated automatically\n";
     } else {
         int size;
@@ -87,6 +123,7 @@ void SetGridSizeAction::execute(Interface& app) {
 
             if (size % 2 == 1 && size >= minGridSize) { // must be odd and big enough
                 app.sessionData.gridSize = size;
+                app.sessionData.autoGridSize = false;
                 break;
             }
             std::cout << "Invalid grid size. Must be an odd number >= " << minGridSize << ".\n";
@@ -117,6 +154,14 @@ void SetRoundsAction::execute(Interface& app) {
 
         if (rounds > 0) {
             app.sessionData.rounds = rounds;
+            if (!app.sessionData.message.empty()) { // show what these rounds will cost for the current message
+                const JobPlan plan = JobPlanner::forEncryption(Encryptor::preparedLength(app.sessionData.message), rounds,
+                                                               app.sessionData.gridSize);
+                printPlan(plan);
+                if (!plan.fits(app.sessionData.memoryBudget)) {
+                    std::cout << "Warning: this is over the memory budget, encryption will refuse it.\n";
+                }
+            }
             break;
         }
         std::cout << "Please enter a positive number.\n";
@@ -128,10 +173,15 @@ void OneRoundPrintAction::execute(Interface& app) {
         std::cout << "No message to encrypt!\n";
         return;
     }
+    if (!withinBudget(app, JobPlanner::forEncryption(Encryptor::preparedLength(app.sessionData.message), 1, app.sessionData.gridSize))) {
+        return;
+    }
     Encryptor encryptor(app.sessionData.gridSize, 1);
+    encryptor.setStats(sessionStats(app));
     std::cout << "\n=== One-Round Encryption Grid ===\n";
     const std::string result = encryptor.encryptWithDisplay(app.sessionData.message);
     std::cout << "Final encrypted message: " << result << "\n";
+    printStats(app);
 }
 
 void MultiRoundPrintAction::execute(Interface& app) {
@@ -140,10 +190,16 @@ void MultiRoundPrintAction::execute(Interface& app) {
         return;
     }
 
+    if (!withinBudget(app, JobPlanner::forEncryption(Encryptor::preparedLength(app.sessionData.message), app.sessionData.rounds,
+                                                     app.sessionData.gridSize))) {
+        return;
+    }
     Encryptor encryptor(app.sessionData.gridSize, app.sessionData.rounds);
+    encryptor.setStats(sessionStats(app));
     std::cout << "\n=== Multi-Round Encryption Steps ===\n";
     const std::string result = encryptor.multiRoundEncryptWithDisplay(app.sessionData.message);
     std::cout << "Final encrypted message: " << result << "\n";
+    printStats(app);
 }
 
 void DecryptionPrintAction::execute(Interface& app) {
@@ -152,49 +208,18 @@ void DecryptionPrintAction::execute(Interface& app) {
         return;
     }
 
-    const Decryptor decryptor(app.sessionData.rounds);
+    if (!withinBudget(app, JobPlanner::forDecryption(app.sessionData.message.size(), app.sessionData.rounds))) {
+        return;
+    }
+    Decryptor decryptor(app.sessionData.rounds, true); // verbose, so the grids get printed
+    decryptor.setStats(sessionStats(app));
     std::cout << "\n=== Decryption Steps ===\n";
     const std::string result = decryptor.decryptWithDisplay(app.sessionData.message);
     std::cout << "Decrypted message before trimming: " << result << "\n";
+    printStats(app);
 }
 
-ExecuteEncryptionAction::ExecuteEncryptionAction(const bool multi) : multiRound(multi) {}
-
-void ExecuteEncryptionAction::execute(Interface& app) {
-    // check for empty message first
-    if (app.sessionData.message.empty()) {
-        std::cout << "Please enter a message first!\n";
-
-        // prompt for immediate message input
-        std::cout << "Enter message now: ";
-        std::cin.ignore();
-        std::getline(std::cin, app.sessionData.message);
-
-        if (app.sessionData.message.empty()) {
-            std::cout << "No message entered. Aborting.\n";
-            return;
-        }
-    }
-
-    try {
-        const int gridSize = app.sessionData.autoGridSize ? 0 : app.sessionData.gridSize;
-        Encryptor encryptor(gridSize, multiRound ? app.sessionData.rounds : 1);
-
-        // use the appropriate encryption method
-        if (multiRound) app.sessionData.message = encryptor.multiRoundEncryptWithDisplay(app.sessionData.message);
-        else app.sessionData.message = encryptor.encryptWithDisplay(app.sessionData.message);
-
-
-    } catch (const std::exception& e) {
-        std::cerr << "Encryption failed: " << e.what() << "\n";
-    }
-}
-
-void ExecuteDecryptionAction::execute(Interface& app) {
-    if (app.sessionData.message.empty()) {
-        std::cout << "Error: No message to decrypt!\n";
-        return;
-    }
-    const Decryptor decryptor(app.sessionData.rounds, true);
-    app.sessionData.message = decryptor.decryptWithDisplay(app.sessionData.message);
+void ToggleStatsAction::execute(Interface& app) {
+    app.sessionData.collectStats = !app.sessionData.collectStats;
+    std::cout << "Engine statistics are " << (app.sessionData.collectStats ? "on, printed as JSON after every run" : "off") << "\n";
 }
\ No newline at end of file
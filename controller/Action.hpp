@@ -62,15 +62,7 @@ public:
     void execute(Interface& app) override;
 };
 
-
-class ExecuteEncryptionAction final : public Action {
-    bool multiRound;
-public:
-    explicit ExecuteEncryptionAction(bool multi);
-    void execute(Interface& app) override;
-};
-
-class ExecuteDecryptionAction final : public Action {
+class ToggleStatsAction final : public Action {
 public:
     void execute(Interface& app) override;
 };
@@ -0,0 +1,249 @@
+#include "CommandLine.hpp"
+#include "../diamond_algorithm/Encryptor.hpp"
+#include "../diamond_algorithm/Decryptor.hpp"
+#include "../diamond_algorithm/Trace.hpp"
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+    // std::sto* stop at the first character that isn't part of the number ("3x" gives 3),
+    // an option value has to be the number and nothing else
+    void checkWhole(const std::string& value, const size_t used) {
+        if (used != value.size()) throw std::invalid_argument("trailing characters in '" + value + "'");
+    }
+
+    int parseInt(const std::string& value) {
+        size_t used = 0;
+        const int number = std::stoi(value, &used);
+        checkWhole(value, used);
+        return number;
+    }
+
+    long long parseLong(const std::string& value) {
+        size_t used = 0;
+        const long long number = std::stoll(value, &used);
+        checkWhole(value, used);
+        return number;
+    }
+
+    unsigned long long parseUnsigned(const std::string& value) {
+        // stoull takes "-1" and wraps it around to the largest value
+        if (value.find('-') != std::string::npos) throw std::invalid_argument("negative value '" + value + "'");
+        size_t used = 0;
+        const unsigned long long number = std::stoull(value, &used);
+        checkWhole(value, used);
+        return number;
+    }
+}
+
+CommandLine::CommandLine(const int argc, char* argv[]) : args(argv + 1, argv + argc) {}
+
+void CommandLine::printUsage(std::ostream& out) {
+    out << "usage: milestone1 encrypt|decrypt [options]\n"
+        << "  --rounds N      number of rounds (default 1)\n"
+        << "  --grid auto|K   grid size for encryption, K odd (default auto)\n"
+        << "  --block K       block mode, blocks fill a KxK diamond (K odd, at most 4095)\n"
+        << "  --threads N     worker threads for block mode, 0 = all cores (default 1)\n"
+        << "  --seed S        fixed padding seed, for reproducible ciphertexts\n"
+        << "  --budget MB     refuse messages planned to need more memory (default 1024)\n"
+        << "  --in FILE       read messages from FILE instead of stdin\n"
+        << "  --out FILE      write results to FILE instead of stdout\n"
+        << "  --mmap          whole file as one message via memory mapping (needs --in and --out)\n"
+        << "  --stats         print timings and counters of every message to stderr as JSON\n"
+        << "  --trace FILE    write engine spans to FILE as Chrome trace-event JSON (tracing builds only)\n"
+        << "one message per line. without arguments the interactive menu starts.\n";
+}
+
+bool CommandLine::parse() {
+    if (args.empty() || (args[0] != "encrypt" && args[0] != "decrypt")) {
+        std::cerr << "Expected 'encrypt' or 'decrypt' as the first argument.\n";
+        return false;
+    }
+    mode = args[0];
+
+    for (size_t i = 1; i < args.size(); ++i) {
+        const std::string& option = args[i];
+        if (option == "--mmap") { // options without a value
+            mapped = true;
+            continue;
+        }
+        if (option == "--stats") {
+            showStats = true;
+            continue;
+        }
+        if (i + 1 >= args.size()) {
+            std::cerr << "Missing value for " << option << ".\n";
+            return false;
+        }
+        const std::string& value = args[++i];
+        try {
+            if (option == "--rounds") {
+                rounds = parseInt(value);
+                if (rounds <= 0) {
+                    std::cerr << "Rounds must be a positive number.\n";
+                    return false;
+                }
+            } else if (option == "--grid") {
+                gridSize = value == "auto" ? 0 : parseInt(value);
+                if (gridSize < 0 || (gridSize > 0 && gridSize % 2 == 0)) {
+                    std::cerr << "Grid size must be 'auto' or an odd positive number.\n";
+                    return false;
+                }
+            } else if (option == "--block") {
+                blockGridSize = parseInt(value);
+                if (blockGridSize <= 0 || blockGridSize % 2 == 0 || blockGridSize > Encryptor::largestBlockGridSize) {
+                    std::cerr << "Block size must be an odd number from 1 to " << Encryptor::largestBlockGridSize << ".\n";
+                    return false;
+                }
+            } else if (option == "--threads") {
+                threads = parseInt(value);
+                if (threads < 0) {
+                    std::cerr << "Threads must be 0 or a positive number.\n";
+                    return false;
+                }
+            } else if (option == "--seed") {
+                seed = parseUnsigned(value);
+            } else if (option == "--budget") {
+                const long long megabytes = parseLong(value); // signed, so "-1" is refused instead of wrapping around
+                if (megabytes <= 0 || static_cast<unsigned long long>(megabytes) > (SIZE_MAX >> 20)) {
+                    std::cerr << "Budget must be a positive number of MB, at most " << (SIZE_MAX >> 20) << ".\n";
+                    return false;
+                }
+                memoryBudget = static_cast<std::uint64_t>(megabytes) << 20;
+            } else if (option == "--in") {
+                inputPath = value;
+            } else if (option == "--out") {
+                outputPath = value;
+            } else if (option == "--trace") {
+                if (!Trace::enabled) {
+                    std::cerr << "This build records no trace spans, configure with -DDIAMOND_ENABLE_TRACING=ON.\n";
+                    return false;
+                }
+                tracePath = value;
+            } else {
+                std::cerr << "Unknown option " << option << ".\n";
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Invalid value '" << value << "' for " << option << ".\n";
+            return false;
+        }
+    }
+    if (mapped && (inputPath.empty() || outputPath.empty())) {
+        std::cerr << "--mmap needs both --in and --out, a mapping can't be made of stdin or stdout.\n";
+        return false;
+    }
+    if (mapped && blockGridSize > 0) {
+        std::cerr << "--mmap and --block can't be combined, a mapped file is always one message.\n";
+        return false;
+    }
+    return true;
+}
+
+void CommandLine::checkBudget(const JobPlan& plan) const {
+    if (plan.fits(memoryBudget)) return;
+    throw std::runtime_error("message needs about " + std::to_string(plan.peakMemory >> 20) + " MB, over the --budget of "
+                             + std::to_string(memoryBudget >> 20) + " MB (use --block or --mmap for large inputs)");
+}
+
+void CommandLine::reportStats(const Stats& stats) const {
+    if (!showStats) return;
+    stats.writeJson(std::cerr);
+    std::cerr << '\n';
+}
+
+void CommandLine::process(std::istream& in, std::ostream& out) const {
+    std::string line;
+    const auto pool = threads == 1 ? nullptr : std::make_shared<ThreadPool>(threads);
+    Stats stats; // only attached with --stats
+    if (mode == "encrypt") {
+        Encryptor encryptor(gridSize, rounds);
+        if (seed) encryptor.setPaddingSeed(*seed);
+        encryptor.setThreadPool(pool);
+        if (showStats) encryptor.setStats(&stats);
+        while (std::getline(in, line)) {
+            if (blockGridSize > 0) { // every block is small, nothing to plan
+                out << encryptor.encryptBlocks(line, blockGridSize) << '\n';
+            } else {
+                checkBudget(JobPlanner::forEncryption(Encryptor::preparedLength(line), rounds, gridSize));
+                out << encryptor.encrypt(line) << '\n';
+            }
+            reportStats(stats);
+        }
+    } else {
+        Decryptor decryptor(rounds);
+        decryptor.setThreadPool(pool);
+        if (showStats) decryptor.setStats(&stats);
+        while (std::getline(in, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back(); // files written on Windows
+            if (blockGridSize > 0) {
+                out << decryptor.decryptBlocks(line) << '\n';
+            } else {
+                checkBudget(JobPlanner::forDecryption(line.size(), rounds));
+                out << decryptor.decrypt(line) << '\n';
+            }
+            reportStats(stats);
+        }
+    }
+}
+
+int CommandLine::run() {
+    if (!parse()) {
+        printUsage(std::cerr);
+        return 2;
+    }
+
+    if (mapped) {
+        try {
+            Stats stats;
+            if (mode == "encrypt") {
+                Encryptor encryptor(gridSize, rounds);
+                if (seed) encryptor.setPaddingSeed(*seed);
+                if (showStats) encryptor.setStats(&stats);
+                encryptor.encryptFile(inputPath, outputPath);
+            } else {
+                Decryptor decryptor(rounds);
+                if (showStats) decryptor.setStats(&stats);
+                decryptor.decryptFile(inputPath, outputPath);
+            }
+            reportStats(stats);
+            if (!tracePath.empty()) Trace::writeFile(tracePath);
+        } catch (const std::exception& e) {
+            std::cerr << "Failed: " << e.what() << "\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    std::ifstream inputFile;
+    std::ofstream outputFile;
+    if (!inputPath.empty()) {
+        inputFile.open(inputPath, std::ios::binary);
+        if (!inputFile) {
+            std::cerr << "Cannot open " << inputPath << " for reading.\n";
+            return 1;
+        }
+    }
+    if (!outputPath.empty()) {
+        outputFile.open(outputPath, std::ios::binary);
+        if (!outputFile) {
+            std::cerr << "Cannot open " << outputPath << " for writing.\n";
+            return 1;
+        }
+    }
+    std::istream& in = inputPath.empty() ? std::cin : inputFile;
+    std::ostream& out = outputPath.empty() ? std::cout : outputFile;
+
+    std::ios::sync_with_stdio(false); // plain stream I/O, nothing else writes to the console
+    try {
+        process(in, out);
+        if (!tracePath.empty()) Trace::writeFile(tracePath); // every span of the run, from all threads
+    } catch (const std::exception& e) {
+        std::cerr << "Failed: " << e.what() << "\n";
+        return 1;
+    }
+    out.flush();
+    return out ? 0 : 1;
+}
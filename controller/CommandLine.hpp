@@ -0,0 +1,47 @@
+#ifndef COMMANDLINE_HPP
+#define COMMANDLINE_HPP
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <optional>
+#include <string>
+#include <vector>
+#include "../diamond_algorithm/JobPlanner.hpp"
+#include "../diamond_algorithm/Stats.hpp"
+
+// headless entry point for scripts and batch jobs:
+//   milestone1 encrypt|decrypt [--rounds N] [--grid auto|K] [--block K] [--threads N] [--seed S] [--budget MB] [--in FILE] [--out FILE] [--mmap] [--stats] [--trace FILE]
+// every input line is one message, every output line the matching result.
+// with --stats the engine Stats of every message go to stderr as one line of JSON.
+// --trace writes the engine spans of the run to FILE as Chrome trace-event JSON (tracing builds only).
+// with --mmap (needs --in and --out) the whole input file is one message, processed through memory mappings.
+// no menus and no display code, messages go straight through the engine.
+// whole-message jobs are planned first (JobPlanner) and refused when they would need more than --budget.
+class CommandLine {
+public:
+    CommandLine(int argc, char* argv[]);
+    int run(); // returns the process exit code
+    static void printUsage(std::ostream& out);
+
+private:
+    std::vector<std::string> args;
+    std::string mode;
+    int rounds = 1;
+    int gridSize = 0; // 0 = automatic
+    int blockGridSize = 0; // 0 = whole messages, otherwise block mode
+    int threads = 1; // 0 = all hardware threads
+    std::optional<std::uint64_t> seed;
+    std::string inputPath;
+    std::string outputPath;
+    bool mapped = false;
+    bool showStats = false;
+    std::string tracePath; // empty = no trace file
+    std::uint64_t memoryBudget = std::uint64_t{1} << 30; // bytes
+
+    bool parse(); // fills the options from args, prints the problem and returns false on bad input
+    void process(std::istream& in, std::ostream& out) const;
+    void checkBudget(const JobPlan& plan) const; // throws std::runtime_error when the job is over memoryBudget
+    void reportStats(const Stats& stats) const; // one JSON line on stderr when --stats is set
+};
+
+#endif
@@ -78,6 +78,7 @@ void Interface::initialiseMenus() {
     // Level 1 Options
     mainMenu->addOption("Encrypt a message", std::make_unique<NavigateAction>(encryptMenu));
     mainMenu->addOption("Decrypt a message", std::make_unique<NavigateAction>(decryptMenu));
+    mainMenu->addOption("Turn engine statistics on/off", std::make_unique<ToggleStatsAction>());
     mainMenu->addOption("Quit", std::make_unique<QuitAction>());
 
     // Level 2: Encryption Options
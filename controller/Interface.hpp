@@ -1,9 +1,11 @@
 #ifndef INTERFACE_HPP
 #define INTERFACE_HPP
+#include <cstdint>
 #include <memory>
 #include <stack>
 #include <map>
 #include "Menu.hpp"
+#include "../diamond_algorithm/Stats.hpp"
 
 class Interface {
 public:
@@ -21,6 +23,9 @@ public:
         int gridSize = 0;
         int rounds = 1;
         bool autoGridSize = false;
+        std::uint64_t memoryBudget = std::uint64_t{1} << 30; // jobs planned to need more bytes are rejected
+        bool collectStats = false; // print the engine Stats as JSON after every run
+        Stats stats; // of the last run, when collectStats is on
     } sessionData;
 
 private:
@@ -0,0 +1,33 @@
+/*
+ AlignedAllocator hands out storage aligned to Alignment bytes (a cache line by default)
+ so flat buffers start on a cache line and suit vector loads.
+ */
+
+#ifndef ALIGNEDALLOCATOR_HPP
+#define ALIGNEDALLOCATOR_HPP
+#include <cstddef> // size_t
+#include <new> // aligned operator new
+
+template <typename T, std::size_t Alignment = 64>
+struct AlignedAllocator {
+  using value_type = T;
+
+  template <typename U>
+  struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+  AlignedAllocator() = default;
+  template <typename U>
+  explicit AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+  T* allocate(const std::size_t count) {
+    return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t{Alignment}));
+  }
+  void deallocate(T* pointer, std::size_t) {
+    ::operator delete(pointer, std::align_val_t{Alignment});
+  }
+
+  template <typename U>
+  bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+};
+
+#endif //ALIGNEDALLOCATOR_HPP
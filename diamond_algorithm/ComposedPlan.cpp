@@ -0,0 +1,99 @@
+#include "ComposedPlan.hpp"
+#include "DiamondGeometry.hpp"
+#include "PlanCache.hpp"
+#include "RoundChain.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace {
+  struct PlanKey {
+    std::size_t length;
+    int rounds;
+    int gridSize; // -1 for decryption, where the grids follow from the length
+    bool operator==(const PlanKey&) const = default;
+  };
+
+  struct PlanKeyHash {
+    std::size_t operator()(const PlanKey& key) const {
+      return (std::hash<std::size_t>{}(key.length) * 31 + std::hash<int>{}(key.rounds)) * 31 + std::hash<int>{}(key.gridSize);
+    }
+  };
+
+  PlanCache<PlanKey, ComposedPlan, PlanKeyHash>& planCache() {
+    static PlanCache<PlanKey, ComposedPlan, PlanKeyHash> cache(256u << 20); // 256 MB by default
+    return cache;
+  }
+}
+
+std::shared_ptr<const ComposedPlan> ComposedPlan::forDecryption(const std::size_t length, const int rounds) {
+  if (rounds <= 0 || length > std::numeric_limits<std::uint32_t>::max()) return nullptr;
+
+  return planCache().get({length, rounds, -1}, [length, rounds]() -> std::shared_ptr<const ComposedPlan> {
+    // the chain of Decryptor::decrypt: grid from sqrt, then trim to the largest odd square.
+    // every final position is followed back with DiamondGeometry (RoundChain), no per-round tables
+    const RoundChain chain = RoundChain::forDecryption(length, rounds);
+    if (!chain.isValid()) return nullptr; // even grids have no plan
+
+    auto plan = std::shared_ptr<ComposedPlan>(new ComposedPlan());
+    plan->inputLength = length;
+    plan->outputLength = chain.getOutputLength();
+    plan->gridSizes = chain.getGridSizes();
+    plan->table.resize(plan->outputLength);
+    for (std::size_t i = 0; i < plan->outputLength; ++i) {
+      plan->table[i] = static_cast<std::uint32_t>(chain.sourcePosition(i));
+    }
+    return plan;
+  });
+}
+
+std::shared_ptr<const ComposedPlan> ComposedPlan::forEncryption(const std::size_t length, const int rounds, const int gridSize) {
+  if (rounds <= 0 || (gridSize > 0 && gridSize % 2 == 0)) return nullptr;
+
+  return planCache().get({length, rounds, std::max(gridSize, 0)}, [length, rounds, gridSize]() -> std::shared_ptr<const ComposedPlan> {
+    // every round lays the previous output into a grid chosen from its length, the output is the full grid.
+    // positions are followed with DiamondGeometry (RoundChain), the only table is the one being built:
+    // no per-round PermutationPlan, the last of which would be as big as the whole output
+    const RoundChain chain = RoundChain::forEncryption(length, rounds, gridSize);
+    if (chain.getOutputLength() > std::numeric_limits<std::uint32_t>::max()) return nullptr;
+
+    auto plan = std::shared_ptr<ComposedPlan>(new ComposedPlan());
+    plan->inputLength = length;
+    plan->outputLength = chain.getOutputLength();
+    plan->gridSizes = chain.getGridSizes();
+    plan->table.resize(length);
+    for (std::size_t i = 0; i < length; ++i) {
+      const std::uint64_t position = chain.encryptedPosition(i); // dropped when it falls off a fixed-size diamond
+      plan->table[i] = position == RoundChain::dropped ? dropped : static_cast<std::uint32_t>(position);
+    }
+    return plan;
+  });
+}
+
+void ComposedPlan::setCacheBudget(const std::size_t bytes) {
+  planCache().setBudget(bytes);
+}
+
+void ComposedPlan::gather(const char* encrypted, char* out) const {
+  const std::size_t count = table.size();
+  for (std::size_t i = 0; i < count; ++i) out[i] = encrypted[table[i]];
+}
+
+std::size_t ComposedPlan::gatherUntil(const char* encrypted, char* out, const char terminator) const {
+  const std::size_t count = table.size();
+  for (std::size_t i = 0; i < count; ++i) {
+    out[i] = encrypted[table[i]];
+    if (out[i] == terminator) return i + 1;
+  }
+  return count;
+}
+
+void ComposedPlan::scatter(const char* message, char* out) const {
+  const std::size_t count = table.size();
+  for (std::size_t i = 0; i < count; ++i) {
+    if (table[i] != dropped) out[table[i]] = message[i];
+  }
+}
+
+std::size_t ComposedPlan::getMemoryUsage() const {
+  return sizeof(ComposedPlan) + table.capacity() * sizeof(std::uint32_t) + gridSizes.capacity() * sizeof(int);
+}
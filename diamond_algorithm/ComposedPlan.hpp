@@ -0,0 +1,55 @@
+/*
+ ComposedPlan folds a whole multi-round chain into one index map.
+ every round's grid size follows from the message length alone, so the
+ per-round PermutationPlans (and the odd-square trimming in between) can be
+ composed once per (length, rounds) and applied in a single pass.
+ */
+
+#ifndef COMPOSEDPLAN_HPP
+#define COMPOSEDPLAN_HPP
+#include <cstddef> // size_t
+#include <cstdint> // 32 bit indices
+#include <memory> // shared plans handed out by the cache
+#include <vector> // index table and round sizes
+
+class ComposedPlan {
+public:
+  static std::shared_ptr<const ComposedPlan> forDecryption(std::size_t length, int rounds);
+    // plan that maps every plaintext position (before trimming at '.') to its ciphertext position
+    // returns nullptr when the chain can't be composed (a round grid of even size, or too long for 32 bit indices)
+  static std::shared_ptr<const ComposedPlan> forEncryption(std::size_t length, int rounds, int gridSize);
+    // plan that maps every prepared message position to its final ciphertext position.
+    // gridSize <= 0 picks each round's grid automatically, like Encryptor::calculateGridSize.
+    // characters that don't fit a fixed grid are dropped, as in Encryptor::encryptCore
+  static void setCacheBudget(std::size_t bytes);
+  static constexpr std::size_t largestTable = std::size_t{1} << 24;
+    // entries (64 MB) callers should build a plan for, longer messages are mapped with RoundChain instead.
+    // the factories themselves only refuse what 32 bit indices can't hold
+
+  void gather(const char* encrypted, char* out) const;
+    // decryption plans: out[i] = encrypted[table[i]] for every output position (getOutputLength() bytes)
+  [[nodiscard]] std::size_t gatherUntil(const char* encrypted, char* out, char terminator) const;
+    // same as gather, but stops after the first terminator and returns how many bytes were written.
+    // ciphertext positions past it are never read
+  void scatter(const char* message, char* out) const;
+    // encryption plans: out[table[i]] = message[i] for every kept message character.
+    // out holds getOutputLength() bytes, every position not written is padding
+
+  static constexpr std::uint32_t dropped = UINT32_MAX; // message character that never reaches the output
+  [[nodiscard]] std::uint32_t operator[](const std::size_t i) const { return table[i]; }
+    // encryption: output position of message character i (or dropped), decryption: source of output position i
+
+  [[nodiscard]] std::size_t getInputLength() const { return inputLength; }
+  [[nodiscard]] std::size_t getOutputLength() const { return outputLength; }
+  [[nodiscard]] const std::vector<int>& getGridSizes() const { return gridSizes; } // grid size of every round, in processing order
+  [[nodiscard]] std::size_t getMemoryUsage() const;
+
+private:
+  ComposedPlan() = default; // only built through the factories
+  std::size_t inputLength = 0;
+  std::size_t outputLength = 0;
+  std::vector<std::uint32_t> table;
+  std::vector<int> gridSizes;
+};
+
+#endif //COMPOSEDPLAN_HPP
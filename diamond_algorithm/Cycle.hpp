@@ -1,20 +1,31 @@
 /*
  Cycle class is designed to determine the movement in diamond pattern
  It is used for both message insertion and extraction from grid.
+ the Observer policy (see GridObserver.hpp) is told about every cell and layer,
+ Cycle is the quiet BasicCycle whose hooks compile away.
  */
 
 #ifndef CYCLE_HPP
 #define CYCLE_HPP
 #include "Grid.hpp" // needed for grid operations
+#include "GridObserver.hpp" // NullGridObserver, the default policy
+#include "DiamondGeometry.hpp" // the diamond walk itself
+#include "PaddingGenerator.hpp" // random letters for padding
+#include "PaddingKernel.hpp" // bulk padding of blank cells
+#include "Trace.hpp"
+#include <algorithm>
 #include <string> // for handling the text messagees
 #include <vector> // stores diamond path coordinates
 #include <utility> // using pairs (row, col)
 
-class Cycle {
+template <typename Observer = NullGridObserver>
+class BasicCycle {
 public:
-  Cycle(Grid* grid, int layer); // constructor that sets up Cycle object
+  BasicCycle(Grid* grid, const int layer, PaddingGenerator* padding = nullptr, Observer observer = {})
+      : layer{layer}, grid{grid}, padding{padding}, observer{observer} {} // constructor that sets up Cycle object
     // grid is a pointer to the Grid I am working on
     // layer tells us which "diamond" i am in. (0- is the outermost layer)
+    // padding supplies the random letters, nullptr uses a per-thread default generator
   void fillWithMessage(const std::string& message, int& msgIndex);
     // this function inserts messages into grid,following diamond path
     // message is the text to be inserted. msgIdx is a reference that tracks current position in message
@@ -24,9 +35,15 @@ public:
     // retrieves message from grid, following diamond path
     // message is where the extracted text is stored
     // msgIndex tracks progress of message extraction
-  [[nodiscard]] std::vector<std::pair<int, int>> getDiamondPath() const;
+  static void fillLayers(Grid& grid, const std::string& message, PaddingGenerator* padding,
+                         std::string* originalLetters = nullptr, std::string* diamondLetters = nullptr);
+    // one encryption round: the message along every layer from the outside in, padding where it runs out.
+    // the letters of each layer are appended to originalLetters/diamondLetters when given
+  [[nodiscard]] std::vector<std::pair<int, int>> getDiamondPath() const { return diamondPath(grid->getSize(), layer); }
   // and getter for calculates coordinates of diamond path
   // return vector of (row, col) pairs
+  [[nodiscard]] static std::vector<std::pair<int, int>> diamondPath(int size, int layer);
+  // same path computed from the grid size alone, no Grid needed
   [[nodiscard]] const std::string& getFullDiamondLetters() const { return fullDiamondLetters; }
   // returns all letters along the diamond path (message + random)
   [[nodiscard]] const std::string& getOriginalMessageLetters() const { return originalMessageLetters; }
@@ -34,10 +51,113 @@ public:
 private:
   int layer; // indicates current diamond layer
   Grid* grid; // ppointer to grid
+  PaddingGenerator* padding; // not owned
+  [[no_unique_address]] Observer observer; // empty for NullGridObserver
+  [[nodiscard]] PaddingGenerator& paddingSource() const {
+    if (padding) return *padding;
+    thread_local XoshiroPadding fallback; // seeded once per thread
+    return fallback;
+  }
   std::string fullDiamondLetters; // debug: stores all letters along diamond path
   std::string originalMessageLetters; // stores only original message letters
 };
 
+using Cycle = BasicCycle<>;
 
+// same walk as getDiamondPath, but only needs the grid size (used to build PermutationPlan tables)
+template <typename Observer>
+std::vector<std::pair<int, int>> BasicCycle<Observer>::diamondPath(const int size, const int layer) {
+  std::vector<std::pair<int, int>> path;
+  path.reserve(DiamondGeometry::layerLength(size, layer));
+  // the four diagonals live in DiamondGeometry::walkLayer, shared with the compile time tables
+  DiamondGeometry::walkLayer(size, layer, [&path](const int row, const int col) { path.emplace_back(row, col); });
+  return path;
+}
+
+template <typename Observer>
+void BasicCycle<Observer>::fillWithMessage(const std::string& message, int& msgIndex) {
+  DIAMOND_TRACE_SCOPE("Cycle::fillWithMessage");
+  auto path = getDiamondPath();
+  fullDiamondLetters.clear();
+  originalMessageLetters.clear();
+
+  // the part of the path the message doesn't reach gets random letters, drawn in one go
+  const std::size_t fromMessage = std::min(path.size(), message.size() - std::min<std::size_t>(msgIndex, message.size()));
+  std::string randomLetters(path.size() - fromMessage, ' ');
+  paddingSource().fillLetters(randomLetters.data(), randomLetters.size());
+
+  for (std::size_t i = 0; i < path.size(); ++i) { // iterate through each coordinate
+    const auto [row, col] = path[i];
+    const bool isMessageChar = i < fromMessage; // check for remaining message chars
+    const char ch = isMessageChar ? message[msgIndex++] : randomLetters[i - fromMessage];
+
+    grid->fillCell(row, col, ch, observer); // places cchar in the grid
+    fullDiamondLetters += ch; // append to full list
+
+    if (isMessageChar) {
+      originalMessageLetters += ch;  // append to original message letters
+    }
+  }
+  observer.onLayerFilled(*grid, layer, fullDiamondLetters);
+}
+
+template <typename Observer>
+void BasicCycle<Observer>::fillLayers(Grid& grid, const std::string& message, PaddingGenerator* padding,
+                                      std::string* originalLetters, std::string* diamondLetters) {
+  int msgIndex = 0;
+  for (int layer = 0; layer < DiamondGeometry::layers(grid.getSize()); ++layer) {
+    BasicCycle cycle(&grid, layer, padding);
+    cycle.fillWithMessage(message, msgIndex);
+    if (originalLetters) *originalLetters += cycle.getOriginalMessageLetters();
+    if (diamondLetters) *diamondLetters += cycle.getFullDiamondLetters();
+  }
+}
+
+// fill remaining empty cells with random letters
+template <typename Observer>
+void BasicCycle<Observer>::fillEmptyCells() const {
+  DIAMOND_TRACE_SCOPE("Cycle::fillEmptyCells");
+  if constexpr (!Observer::watchesCells) {
+    // nobody watches single cells, so blend padding into the blank cells in bulk
+    padBlankCells(grid->data(), grid->getCellCount(), paddingSource());
+  } else {
+    const int size = grid->getSize();
+
+    std::size_t empty = 0;
+    for (int row = 0; row < size; ++row) {
+      for (int col = 0; col < size; ++col) {
+        if (grid->getCell(row, col) == ' ') ++empty; // count empty cells first
+      }
+    }
+    std::string randomLetters(empty, ' ');
+    paddingSource().fillLetters(randomLetters.data(), randomLetters.size());
+
+    std::size_t next = 0;
+    for (int row = 0; row < size; ++row) {
+      for (int col = 0; col < size; ++col) {
+        if (grid->getCell(row, col) == ' ') { // check empty cells
+          grid->fillCell(row, col, randomLetters[next++], observer);
+        }
+      }
+    }
+  }
+}
+
+template <typename Observer>
+void BasicCycle<Observer>::extractToMessage(std::string& message, int& msgIndex) {
+  auto path = getDiamondPath();
+  fullDiamondLetters.clear();
+  originalMessageLetters.clear();
+
+  for (const auto& [row, col] : path) {
+    if (const char c = grid->getCell(row, col); c != ' ') { // checks for non empty cells
+      message += c; // append char to emssage
+      fullDiamondLetters += c;
+      originalMessageLetters += c;
+      ++msgIndex;
+    }
+  }
+  observer.onLayerExtracted(*grid, layer, fullDiamondLetters);
+}
 
 #endif //CYCLE_HPP
@@ -1,174 +1,308 @@
 #include "Decryptor.hpp"
-#include <cmath>
-#include <iostream>
-#include <windows.h>
+#include "ComposedPlan.hpp"
+#include "DiamondCipher.hpp"
+#include "DiamondGeometry.hpp"
+#include "Encryptor.hpp"
+#include "FixedKernels.hpp"
+#include "GridView.hpp"
+#include "JobPlanner.hpp"
+#include "MappedFile.hpp"
+#include "RoundChain.hpp"
+#include "Trace.hpp"
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
 
 Decryptor::Decryptor(const int rounds, const bool verbose)
     : rounds(rounds), verbose(verbose) {}
+
+void Decryptor::setThreadPool(std::shared_ptr<ThreadPool> threadPool) {
+    pool = std::move(threadPool);
+}
 // 'rounds' is number of decryption rounds to perform
-// verbose controls whether to display detailed output or not
-std::string Decryptor::decryptSingleRound(const std::string& encrypted) const {
-    const int gridSize = static_cast<int>(std::sqrt(encrypted.size()));
+void Decryptor::decryptSingleRound(const std::string_view encrypted, std::string& message, Stats* record) const {
+    DIAMOND_TRACE_SCOPE("Decryptor::decryptSingleRound");
+    const int gridSize = DiamondGeometry::gridSizeOfCipher(encrypted.size());
     // calculates grid size based on encrypted message length
     // assume encrypted message can form square grid
-    if(verbose) {
-        SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 14);
-        std::cout << "\nGrid size: " << gridSize << "x" << gridSize
-                  << " | Message length: " << encrypted.size() << "\n";
-    }
-    Grid grid(gridSize);
-    grid.fillColumnByColumn(encrypted);
-    // create grid object and fill ti with encrypted message, column by column
-    if(verbose) {
-        displayGridState(grid);
-    }
-
-    std::string message;
-    int msgIndex = 0;
-    const int layers = (gridSize + 1) / 2;
-    // initialises empty message string, message index, and calculates number of layers
-    for(int layer = 0; layer < layers; ++layer) {
-        Cycle cycle(&grid, layer);
-        auto path = cycle.getDiamondPath();
-        if(verbose) {
-            displayLayerExtraction(layer, path); // show extraction path for current layer
+    if(record) record->beginRound(gridSize, encrypted.size());
+    {
+        const Stats::Timer timer(record, Stats::Phase::Extract);
+        if(gridSize % 2 == 1 && FixedKernels::supports(gridSize)) {
+            message.resize(DiamondGeometry::capacity(gridSize)); // within the reserved capacity when called from the round loops
+            FixedKernels::gather(gridSize, encrypted.data(), message.data()); // one gather in diamond order
+            std::erase(message, ' '); // blank cells are skipped, same as Cycle::extractToMessage
+        } else {
+            // the ciphertext already is the grid in column order, so the diamond is read straight out of it:
+            // no Grid, no ingest copy, one pass over the input
+            GridView(encrypted).extractDiamond(message);
         }
-
-        cycle.extractToMessage(message, msgIndex); // extracts message from grid using cycle path
     }
-    if(verbose) {
-        SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 10);
-        std::cout << "\nExtracted message segment: " << message << "\n";
-        SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 7);
-    }
-    return message;
+    if(record) record->endRound(message.size());
 }
 
 std::string Decryptor::decrypt(const std::string& encryptedMessage) const {
-    std::string current = encryptedMessage;
-    // initialises current with encrypted message. modified in each round
-    for(int i = 0; i < rounds; ++i) {
-        if(verbose) {
-            displayDecryptionHeader(i+1, rounds);
-            std::cout << "Processing: " << current << "\n"; // displays decryption round header and message being processed
-        }
-        current = decryptSingleRound(current); // decrypt message for single round
-        if(verbose && i < rounds - 1) {
-            SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 12);
-            std::cout << "\nPreparing for next round...\n";
-            std::cout << "Trimmed message: " << current << "\n";
-            SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 7); // display message indicating prep for next round and trim
+    return decryptSinglePass(encryptedMessage); // never prints, decryptWithDisplay shows the rounds
+}
+
+std::string Decryptor::decryptSinglePass(const std::string& encryptedMessage) const {
+    const Stats::Call call(stats, encryptedMessage.size());
+    // everything after the first period is padding, so no path reads past it
+    const bool blankFree = encryptedMessage.find(' ') == std::string::npos;
+    if(const int single = DiamondGeometry::gridSizeOfCipher(encryptedMessage.size());
+       rounds == 1 && blankFree && FixedKernels::supports(single)) {
+        if(stats) stats->beginRound(single, encryptedMessage.size());
+        std::string message;
+        {
+            const Stats::Timer timer(stats, Stats::Phase::Extract);
+            message = decryptUntrimmed(encryptedMessage); // a whole small grid costs less than stopping early
         }
-        if(i < rounds - 1) {
-            current = prepareForNextRound(current);
+        if(stats) stats->endRound(message.size());
+        const Stats::Timer timer(stats, Stats::Phase::Trim);
+        if(const size_t dot = message.find('.'); dot != std::string::npos) message.resize(dot + 1);
+        call.setOutput(message.size());
+        return message;
+    }
+    // the table has an entry per plaintext character (never more than the ciphertext). past ComposedPlan::largestTable
+    // the rounds run one after another instead: the round buffers read the grids in order, no table is built
+    std::shared_ptr<const ComposedPlan> plan;
+    if(rounds > 1 && blankFree && encryptedMessage.size() <= ComposedPlan::largestTable) {
+        const Stats::Timer timer(stats, Stats::Phase::PathBuild);
+        plan = ComposedPlan::forDecryption(encryptedMessage.size(), rounds);
+    }
+    if(!plan) {
+        std::string message = decryptRounds(encryptedMessage, true, stats);
+        call.setOutput(message.size());
+        return message;
+    }
+    if(stats) {
+        // one pass for every round, the rounds only have their sizes
+        stats->composed = true;
+        std::uint64_t length = encryptedMessage.size();
+        for(size_t round = 0; round < plan->getGridSizes().size(); ++round) {
+            const int size = plan->getGridSizes()[round];
+            stats->beginRound(size, length);
+            length = DiamondGeometry::capacity(size);
+            stats->endRound(length);
+            if(round + 1 < plan->getGridSizes().size()) length = DiamondGeometry::oddSquareTrim(length);
         }
     }
-    if(const size_t dot = current.find('.'); dot != std::string::npos) {     // trim at first period
-        current = current.substr(0, dot + 1);
+    std::string message(plan->getOutputLength(), ' ');
+    {
+        const Stats::Timer timer(stats, Stats::Phase::Extract);
+        message.resize(plan->gatherUntil(encryptedMessage.data(), message.data(), '.')); // only the sources of the kept prefix
+    }
+    call.setOutput(message.size());
+    return message;
+}
+
+std::string Decryptor::decryptRange(const std::string& encryptedMessage, const size_t offset, const size_t count) const {
+    // grid size of every round, from the ciphertext length alone
+    const RoundChain chain = RoundChain::forDecryption(encryptedMessage.size(), rounds);
+    if(rounds <= 0 || !chain.isValid() || encryptedMessage.find(' ') != std::string::npos) {
+        const std::string full = decryptRounds(encryptedMessage);
+        return offset < full.size() ? full.substr(offset, count) : std::string();
     }
-    if(verbose) {
-        SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 10);
-        std::cout << "\n==================== FINAL RESULT ====================\n";
-        std::cout << "Decrypted message: " << current << "\n";
-        std::cout << "Message length: " << current.size() << "\n";
-        SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 7);
+
+    const size_t length = chain.getOutputLength();
+    const size_t end = offset < length ? offset + std::min(count, length - offset) : offset;
+    std::string result;
+    result.reserve(end - offset);
+    for(size_t position = offset; position < end; ++position) {
+        result += encryptedMessage[chain.sourcePosition(position)]; // one ciphertext byte per plaintext character
     }
-    return current;
+    return result;
 }
 
-std::string Decryptor::prepareForNextRound(const std::string& message) {
-    const int len = static_cast<int>(message.size());// gets length of message
+void Decryptor::decryptFile(const std::string& inputPath, const std::string& outputPath) const {
+    const MappedFile input = MappedFile::openRead(inputPath, MappedFile::Access::Random); // gathered out of order
+    std::string_view text(input.data(), input.size());
+    // the line end an editor or `echo` adds is not part of the grid, anything else is (blank cells included)
+    if(text.ends_with('\n')) text.remove_suffix(text.ends_with("\r\n") ? 2 : 1);
+    const Stats::Call call(stats, text.size());
 
-    int raw = static_cast<int>(std::floor(std::sqrt(len))); // largest odd sqrt ≤ len
-    if (raw % 2 == 0) --raw;
-    raw = std::max(raw, 1);          // at least 1×1
-    const int prevSquare = raw * raw;      // full-grid size
-    return message.substr(0, prevSquare);
-    // calculates largest odd sqrt less than or equal to message length
+    if(rounds < 0 || !RoundChain::forDecryption(text.size(), rounds).isValid() || text.find(' ') != std::string_view::npos) {
+        const std::string message = decryptRounds(text, true, stats); // no closed form, round by round from the mapping
+        MappedFile output = MappedFile::create(outputPath, message.size(), MappedFile::Access::Sequential);
+        std::copy(message.begin(), message.end(), output.data());
+        call.setOutput(message.size());
+        return;
+    }
+
+    // DiamondCipher gathers the plaintext straight from the mapping, stopping at the terminating '.'
+    const DiamondCipher cipher(0, rounds);
+    MappedFile output = MappedFile::create(outputPath, cipher.decryptedSize(text), MappedFile::Access::Sequential);
+    const size_t written = cipher.decrypt(text, {output.data(), output.size()});
+    output.truncate(written);
+    call.setOutput(written);
 }
 
-std::string Decryptor::decryptWithDisplay(const std::string& encryptedMessage) const {
-    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 14);
-    std::cout << "\n======================================\n";
-    std::cout << "\n    STARTING DECRYPTION PROCESS       ";
-    std::cout << "\n======================================\n";
-    std::cout << "  Input length: " << encryptedMessage.size() << " characters\n";
-    std::cout << "  Rounds configured: " << rounds << "\n";
-    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 7);
-
-    std::string current = encryptedMessage;
-
-    for (int round = 1; round <= rounds; ++round) {
-        SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 11);
-        std::cout << "\n-----ROUND " << round << "/" << rounds << " -----\n";
-        SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 7);
-
-        current = decryptSingleRound(current);
-
-        SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 8);
-        std::cout << "After round " << round << ": "
-                 << (current.size() > 40 ? current.substr(0, 40) + "..." : current)
-                 << " (" << current.size() << " chars)\n";
-        SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 7);
-
-        if (round < rounds) {
-            current = prepareForNextRound(current);
-            std::cout << "  (Trimmed for next round)\n";
+std::string Decryptor::decryptBlocks(const std::string& encryptedBlocks) const {
+    // find every block first: (ciphertext start, ciphertext length, plaintext length)
+    const Stats::Call call(stats, encryptedBlocks.size());
+    struct Block { size_t start; size_t cipherLength; size_t plainLength; };
+    std::vector<Block> blocks;
+    constexpr size_t largestBlock = DiamondGeometry::capacity(Encryptor::largestBlockGridSize);
+    constexpr size_t headerDigits = 7; // enough for largestBlock, a longer header can't be one
+    size_t position = 0;
+    size_t total = 0; // plaintext length of all blocks
+    while(position < encryptedBlocks.size()) {
+        // header: plaintext length of the block, then ':'
+        const size_t colon = encryptedBlocks.find(':', position);
+        if(colon == std::string::npos || colon == position || colon - position > headerDigits) {
+            throw std::invalid_argument("malformed block header");
+        }
+        size_t plainLength = 0;
+        for(size_t i = position; i < colon; ++i) {
+            if(!std::isdigit(static_cast<unsigned char>(encryptedBlocks[i]))) {
+                throw std::invalid_argument("malformed block header");
+            }
+            plainLength = plainLength * 10 + (encryptedBlocks[i] - '0');
         }
+        if(plainLength == 0 || plainLength > largestBlock) {
+            throw std::invalid_argument("block length " + std::to_string(plainLength) + " is not between 1 and "
+                                        + std::to_string(largestBlock));
+        }
+        // the ciphertext length follows from the plaintext length alone
+        const size_t cipherLength = DiamondGeometry::encryptedLength(plainLength, rounds);
+        if(encryptedBlocks.size() - (colon + 1) < cipherLength) {
+            throw std::invalid_argument("truncated block");
+        }
+        blocks.push_back({colon + 1, cipherLength, plainLength});
+        total += plainLength;
+        position = colon + 1 + cipherLength;
+    }
+
+    // the headers give every block's place in the output, so the blocks are decrypted straight into it
+    std::vector<size_t> starts(blocks.size());
+    for(size_t i = 1; i < blocks.size(); ++i) starts[i] = starts[i - 1] + blocks[i - 1].plainLength;
+    std::string message(total, ' ');
+    const std::string_view encrypted = encryptedBlocks;
+    const auto decryptBlock = [&](const size_t i) {
+        const std::string block = decryptUntrimmed(encrypted.substr(blocks[i].start, blocks[i].cipherLength));
+        if(block.size() < blocks[i].plainLength) throw std::invalid_argument("block shorter than its header");
+        // the rest of the first grid's diamond is padding
+        std::copy_n(block.begin(), blocks[i].plainLength, message.begin() + static_cast<std::ptrdiff_t>(starts[i]));
+    };
+    if(pool) {
+        pool->parallelFor(blocks.size(), decryptBlock);
+    } else {
+        for(size_t i = 0; i < blocks.size(); ++i) decryptBlock(i);
     }
-    displayFinalResult(current);
-    return current;
+    call.setOutput(message.size());
+    return message;
 }
 
-void Decryptor::displayFinalResult(const std::string& result) {
-    const size_t pos = result.find('.'); // position of dot
+void Decryptor::decryptBatch(const std::span<const std::string_view> encryptedMessages, std::string& arena, std::vector<size_t>& offsets) const {
+    // decrypts [first, last) into out, appending the end offset of every message to ends
+    const auto decryptRange = [&](const size_t first, const size_t last, std::string& out, std::vector<size_t>& ends) {
+        std::unordered_map<size_t, std::shared_ptr<const ComposedPlan>> plans; // repeated lengths skip the shared cache
+        for(size_t i = first; i < last; ++i) {
+            const std::string_view encrypted = encryptedMessages[i];
+            const size_t start = out.size();
+            std::shared_ptr<const ComposedPlan> plan;
+            if(encrypted.find(' ') == std::string_view::npos) {
+                auto [found, added] = plans.try_emplace(encrypted.size());
+                if(added) found->second = ComposedPlan::forDecryption(encrypted.size(), rounds);
+                plan = found->second;
+            }
+            if(plan) {
+                out.resize(start + plan->getOutputLength());
+                out.resize(start + plan->gatherUntil(encrypted.data(), out.data() + start, '.')); // straight into the arena
+            } else {
+                out += decryptRounds(encrypted, true);
+            }
+            ends.push_back(out.size());
+        }
+    };
 
-    std::string message;
+    arena.clear(); // keeps the caller's capacity
+    offsets.assign(1, 0);
+    offsets.reserve(encryptedMessages.size() + 1);
 
-    if (pos != std::string::npos) {
-        message = result.substr(0, pos + 1);
+    constexpr size_t chunk = 1024; // messages per parallel job
+    const size_t chunks = (encryptedMessages.size() + chunk - 1) / chunk;
+    if(!pool || chunks <= 1) {
+        decryptRange(0, encryptedMessages.size(), arena, offsets);
+        return;
     }
-    else message = result;
-
-    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 10);
-    std::cout << "\n======================================\n";
-    std::cout << "       DECRYPTION COMPLETE              ";
-    std::cout << "\n======================================\n";
-    std::cout << "  Final message: " << message << "\n";
-    std::cout << "  Message length: " << message.size() << " characters\n";
+    // plaintext lengths are only known after trimming, so each job fills its own buffer and they are joined in order
+    std::vector<std::string> parts(chunks);
+    std::vector<std::vector<size_t>> ends(chunks);
+    pool->parallelFor(chunks, [&](const size_t job) {
+        decryptRange(job * chunk, std::min(encryptedMessages.size(), (job + 1) * chunk), parts[job], ends[job]);
+    });
+    for(size_t job = 0; job < chunks; ++job) {
+        const size_t base = arena.size();
+        arena += parts[job];
+        for(const size_t end : ends[job]) offsets.push_back(base + end);
+    }
+}
 
-    // Validate the message
-    if (message.empty() || message.back() != '.') {
-        SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 12);
-        std::cout << "  WARNING: Message may be incomplete (missing termination)\n";
-    } else {
-        SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 2);
-        std::cout << "  Message properly terminated with '.'\n";
+std::string Decryptor::decryptUntrimmed(const std::string_view encryptedMessage) const {
+    DIAMOND_TRACE_SCOPE("Decryptor::decryptUntrimmed"); // one per block in block mode
+    // blank cells are skipped during extraction, which shifts positions, so only compose space-free input
+    const bool blankFree = encryptedMessage.find(' ') == std::string_view::npos;
+    if(const int single = DiamondGeometry::gridSizeOfCipher(encryptedMessage.size());
+       rounds == 1 && blankFree && FixedKernels::supports(single)) {
+        std::string message(DiamondGeometry::capacity(single), ' ');
+        FixedKernels::gather(single, encryptedMessage.data(), message.data()); // one small grid, no plan lookup
+        return message;
+    }
+    if(rounds == 1) {
+        std::string message;
+        GridView(encryptedMessage).extractDiamond(message); // a single round needs no index table
+        return message;
+    }
+    const auto plan = blankFree && encryptedMessage.size() <= ComposedPlan::largestTable
+                          ? ComposedPlan::forDecryption(encryptedMessage.size(), rounds) : nullptr;
+    if(!plan) {
+        return decryptRounds(encryptedMessage);
     }
-    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 7);
+    std::string message(plan->getOutputLength(), ' ');
+    plan->gather(encryptedMessage.data(), message.data()); // all rounds in one pass over the input
+    return message;
 }
 
-void Decryptor::displayDecryptionHeader(const int pass, const int total) {
-    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 11);
-    std::cout << "\n============================================================";
-    std::cout << "\n       DECRYPTION PASS " << pass << "/" << total << "       ";
-    std::cout << "\n============================================================\n";
-    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 7);
+std::string Decryptor::decryptRounds(const std::string_view encryptedMessage, const bool trim, Stats* record) const {
+    if(rounds <= 0) {
+        std::string message(encryptedMessage);
+        if(const size_t dot = message.find('.'); trim && dot != std::string::npos) message.resize(dot + 1);
+        return message;
+    }
+    std::string buffers[2];
+    reserveRounds(encryptedMessage.size(), buffers[0], buffers[1]);
+    std::string_view source = encryptedMessage;
+    for(int i = 0; i < rounds; ++i) {
+        std::string& target = buffers[i % 2]; // the other buffer holds this round's input
+        if(trim && i == rounds - 1) {
+            if(record) record->beginRound(DiamondGeometry::gridSizeOfCipher(source.size()), source.size());
+            {
+                const Stats::Timer timer(record, Stats::Phase::Extract);
+                GridView(source).extractUntil(target, '.'); // the last round stops at the first period
+            }
+            if(record) record->endRound(target.size());
+            break;
+        }
+        decryptSingleRound(source, target, record);
+        if(i < rounds - 1) prepareForNextRound(target, record);
+        source = target;
+    }
+    return std::move(buffers[(rounds - 1) % 2]);
 }
 
-void Decryptor::displayGridState(const Grid& grid) {
-    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 8);
-    std::cout << "=== Reconstructed Grid ===" << std::endl;
-    grid.display();
-    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 7);
+void Decryptor::reserveRounds(const size_t length, std::string& first, std::string& second) const {
+    const size_t largest = JobPlanner::forDecryption(length, rounds).largestOutput;
+    first.reserve(largest);
+    second.reserve(largest);
 }
 
-void Decryptor::displayLayerExtraction(const int layer, const std::vector<std::pair<int, int>>& path) {
-    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 10);
-    std::cout << "\nLayer " << layer << " extraction path: ";
-    for(const auto& [row, col] : path) {
-        std::cout << "(" << row << "," << col << ") ";
-    }
-    std::cout << "\n";
-    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 7);
-}
\ No newline at end of file
+void Decryptor::prepareForNextRound(std::string& message, Stats* record) {
+    DIAMOND_TRACE_SCOPE("Decryptor::prepareForNextRound");
+    const Stats::Timer timer(record, Stats::Phase::Trim);
+    // keeps the largest odd square that fits in the message: the previous round's full grid.
+    // only ever shrinks (an empty round stays empty), which just moves the end, nothing is copied
+    message.resize(DiamondGeometry::nextRoundLength(message.size()));
+}
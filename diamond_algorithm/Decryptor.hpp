@@ -4,6 +4,12 @@
 #include <string>  // added missing include - for using std::string
 #include "Grid.hpp"  // includes the Grid class definition
 #include "Cycle.hpp"  // includes the Cycle class definition
+#include "ThreadPool.hpp"  // optional pool for block decryption
+#include "Stats.hpp"  // optional per phase timings
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
 
 
 class Decryptor {
@@ -11,15 +17,50 @@ public:
     explicit Decryptor(int rounds, bool verbose = false);
     // constructor: sets up a Decryptor object.
     // rounds: the number of decryption rounds to perform.
-    // verbose: a flag to control detailed output (true = show details).
+    // verbose: a flag to control detailed output (true = decryptWithDisplay also shows every grid).
     // explicit: prevents unintended type conversions.
 
+    void setThreadPool(std::shared_ptr<ThreadPool> threadPool);
+    // decrypts blocks in parallel on this pool. nullptr (the default) keeps everything on the calling thread.
+
+    void setStats(Stats* target) { stats = target; }
+    // filled in by every call, nullptr (the default) measures nothing.
+    // blocks and files only get totals, bytes and allocations, batches are not measured.
+
     [[nodiscard]] std::string decrypt(const std::string& encryptedMessage) const;
-    // decrypts an encrypted message.
+    // decrypts an encrypted message, without printing anything.
     // encryptedMessage: the message to be decrypted.
     // [[nodiscard]]: indicates that the return value should be used.
     // const: indicates that this function does not modify the Decryptor object.
 
+    [[nodiscard]] std::string decryptSinglePass(const std::string& encryptedMessage) const;
+    // decrypts all rounds with one composed index map, without building the intermediate rounds.
+    // gives the same result as decrypt(), falls back to round by round when the chain can't be composed.
+    // either way nothing past the terminating '.' is read.
+
+    [[nodiscard]] std::string decryptRange(const std::string& encryptedMessage, size_t offset, size_t count) const;
+    // decrypts only plaintext characters [offset, offset + count), reading just the ciphertext bytes they come from.
+    // positions are in the untrimmed plaintext, so the range may run past the terminating '.' into padding.
+    // costs O(count * rounds) instead of decrypting the whole message.
+
+    [[nodiscard]] std::string decryptBlocks(const std::string& encryptedBlocks) const;
+    // decrypts the output of Encryptor::encryptBlocks block by block and joins the blocks.
+    // the headers give the exact length of every block, so the prepared message comes back whole.
+    // throws std::invalid_argument on a malformed or truncated block, or a header longer than
+    // the diamond of Encryptor::largestBlockGridSize.
+
+    void decryptBatch(std::span<const std::string_view> encryptedMessages, std::string& arena, std::vector<size_t>& offsets) const;
+    // decrypts many messages into one caller-owned arena: plaintext i (trimmed at its first '.')
+    // is arena[offsets[i], offsets[i + 1]). plans are shared across the batch and the arena keeps
+    // its capacity between calls. with a thread pool the batch is split into parallel jobs.
+
+    void decryptFile(const std::string& inputPath, const std::string& outputPath) const;
+    // decrypts a file written by Encryptor::encryptFile through memory mappings and DiamondCipher, reading only the
+    // ciphertext bytes up to the terminating '.'. the file content is the ciphertext, as passed to decrypt(),
+    // except that one trailing "\n" or "\r\n" is dropped. throws std::runtime_error on I/O errors.
+
+    // console output (DecryptorDisplay.cpp, only built into the interactive program)
+
     [[nodiscard]] std::string decryptWithDisplay(const std::string& encryptedMessage) const;
     // decrypts an encrypted message and displays the process.
     // encryptedMessage: the message to be decrypted.
@@ -56,13 +97,29 @@ private:
     int rounds;  // stores the number of decryption rounds
     bool verbose; // flag to control verbose output
     std::string diamondLetters; // stores extracted diamond letters
-    [[nodiscard]] std::string decryptSingleRound(const std::string& encrypted) const;
+    std::shared_ptr<ThreadPool> pool; // optional, shared with other engines
+    Stats* stats = nullptr; // not owned
+    [[nodiscard]] std::string decryptUntrimmed(std::string_view encryptedMessage) const;
+    // all rounds (composed when possible), without trimming at the terminating '.'.
+
+    [[nodiscard]] std::string decryptRounds(std::string_view encryptedMessage, bool trim = false, Stats* record = nullptr) const;
+    // runs every round one after another. trim stops the last round at the terminating '.',
+    // without it the whole last diamond is returned. record is nullptr inside blocks and batches.
+
+    void decryptSingleRound(std::string_view encrypted, std::string& message, Stats* record = nullptr) const;
     // decrypts the message for a single round.
     // encrypted: the message to decrypt in this round.
-    // [[nodiscard]]: indicates that the return value should be used.
+    // message: receives the result, its capacity is reused so the round loops don't allocate.
+    // record: stats of the running call, if any.
+
+    void decryptSingleRoundWithDisplay(std::string_view encrypted, std::string& message, Stats* record = nullptr) const;
+    // same round, after printing its grid and extraction paths (DecryptorDisplay.cpp).
+
+    void reserveRounds(size_t length, std::string& first, std::string& second) const;
+    // sizes both round buffers for the largest round of a length character ciphertext.
 
-    static std::string prepareForNextRound(const std::string& message);
-    // prepares the message for the next decryption round (e.g., trimming).
+    static void prepareForNextRound(std::string& message, Stats* record = nullptr);
+    // prepares the message for the next decryption round (trimming in place).
     // message: the message to prepare.
     // static: can be called without creating a Decryptor object.
 };
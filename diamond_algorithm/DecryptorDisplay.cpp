@@ -0,0 +1,128 @@
+#include "Decryptor.hpp"
+#include "Cycle.hpp"
+#include "DiamondGeometry.hpp"
+#include "Grid.hpp"
+#include "GridObserver.hpp"
+#include "Trace.hpp"
+#include <iostream>
+#include <windows.h>
+
+// the printing half of Decryptor. Decryptor.cpp never writes to the console, so it is part of
+// diamond_core, this file is only built into the interactive program
+
+void Decryptor::decryptSingleRoundWithDisplay(const std::string_view encrypted, std::string& message, Stats* record) const {
+    DIAMOND_TRACE_SCOPE("Decryptor::decryptSingleRoundWithDisplay");
+    const int gridSize = DiamondGeometry::gridSizeOfCipher(encrypted.size());
+    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 14);
+    std::cout << "\nGrid size: " << gridSize << "x" << gridSize
+              << " | Message length: " << encrypted.size() << "\n";
+    // rebuild the grid only to show it, extraction reads the message directly
+    Grid grid(gridSize);
+    grid.fillColumnByColumn(encrypted, ConsoleGridObserver{});
+    displayGridState(grid);
+    for(int layer = 0; layer < DiamondGeometry::layers(gridSize); ++layer) {
+        displayLayerExtraction(layer, Cycle::diamondPath(gridSize, layer)); // show extraction path for current layer
+    }
+
+    decryptSingleRound(encrypted, message, record);
+    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 10);
+    std::cout << "\nExtracted message segment: " << message << "\n";
+    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 7);
+}
+
+std::string Decryptor::decryptWithDisplay(const std::string& encryptedMessage) const {
+    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 14);
+    std::cout << "\n======================================\n";
+    std::cout << "\n    STARTING DECRYPTION PROCESS       ";
+    std::cout << "\n======================================\n";
+    std::cout << "  Input length: " << encryptedMessage.size() << " characters\n";
+    std::cout << "  Rounds configured: " << rounds << "\n";
+    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 7);
+
+    const Stats::Call call(stats, encryptedMessage.size());
+    std::string buffers[2];
+    reserveRounds(encryptedMessage.size(), buffers[0], buffers[1]);
+    std::string_view source = encryptedMessage;
+
+    for (int round = 1; round <= rounds; ++round) {
+        SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 11);
+        std::cout << "\n-----ROUND " << round << "/" << rounds << " -----\n";
+        SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 7);
+
+        std::string& current = buffers[round % 2];
+        if(verbose) {
+            decryptSingleRoundWithDisplay(source, current, stats);
+        } else {
+            decryptSingleRound(source, current, stats);
+        }
+
+        SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 8);
+        std::cout << "After round " << round << ": "
+                 << (current.size() > 40 ? current.substr(0, 40) + "..." : current)
+                 << " (" << current.size() << " chars)\n";
+        SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 7);
+
+        if (round < rounds) {
+            prepareForNextRound(current, stats);
+            std::cout << "  (Trimmed for next round)\n";
+        }
+        source = current;
+    }
+    std::string result = rounds > 0 ? std::move(buffers[rounds % 2]) : std::string(encryptedMessage);
+    displayFinalResult(result);
+    call.setOutput(result.size());
+    return result;
+}
+
+void Decryptor::displayFinalResult(const std::string& result) {
+    const size_t pos = result.find('.'); // position of dot
+
+    std::string message;
+
+    if (pos != std::string::npos) {
+        message = result.substr(0, pos + 1);
+    }
+    else message = result;
+
+    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 10);
+    std::cout << "\n======================================\n";
+    std::cout << "       DECRYPTION COMPLETE              ";
+    std::cout << "\n======================================\n";
+    std::cout << "  Final message: " << message << "\n";
+    std::cout << "  Message length: " << message.size() << " characters\n";
+
+    // Validate the message
+    if (message.empty() || message.back() != '.') {
+        SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 12);
+        std::cout << "  WARNING: Message may be incomplete (missing termination)\n";
+    } else {
+        SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 2);
+        std::cout << "  Message properly terminated with '.'\n";
+    }
+    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 7);
+}
+
+void Decryptor::displayDecryptionHeader(const int pass, const int total) {
+    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 11);
+    std::cout << "\n============================================================";
+    std::cout << "\n       DECRYPTION PASS " << pass << "/" << total << "       ";
+    std::cout << "\n============================================================\n";
+    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 7);
+}
+
+void Decryptor::displayGridState(const Grid& grid) {
+    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 8);
+    std::cout << "=== Reconstructed Grid ===" << std::endl;
+    grid.display(std::cout);
+    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 7);
+}
+
+void Decryptor::displayLayerExtraction(const int layer, const std::vector<std::pair<int, int>>& path) {
+    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 10);
+    std::cout << "\nLayer " << layer << " extraction path: ";
+    for(const auto& [row, col] : path) {
+        std::cout << "(" << row << "," << col << ") ";
+    }
+    std::cout << "\n";
+    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 7);
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#include "DiamondCipher.hpp"
+#include "ComposedPlan.hpp"
+#include "DiamondGeometry.hpp"
+#include "Encryptor.hpp"
+#include "RoundChain.hpp"
+#include <cctype>
+#include <stdexcept>
+
+DiamondCipher::DiamondCipher(const int gridSize, const int rounds)
+    : gridSize{gridSize}, rounds{rounds} {
+  validate();
+}
+
+DiamondCipher::DiamondCipher(const int gridSize, const int rounds, const std::uint64_t seed)
+    : gridSize{gridSize}, rounds{rounds}, padding{seed} {
+  validate();
+}
+
+void DiamondCipher::validate() const {
+  if (rounds < 0) throw std::invalid_argument("rounds must not be negative");
+  if (gridSize > 0 && gridSize % 2 == 0) throw std::invalid_argument("grid size must be odd"); // even grids have no closed form
+}
+
+std::size_t DiamondCipher::encryptedSize(const std::span<const char> message) const {
+  return DiamondGeometry::encryptedLength(Encryptor::preparedLength({message.data(), message.size()}), rounds, gridSize);
+}
+
+std::size_t DiamondCipher::encrypt(const std::span<const char> message, const std::span<char> out) {
+  return encrypt(message, out, padding);
+}
+
+std::size_t DiamondCipher::encrypt(const std::span<const char> message, const std::span<char> out, PaddingGenerator& letters) const {
+  const std::size_t length = Encryptor::preparedLength({message.data(), message.size()});
+  const std::size_t size = DiamondGeometry::encryptedLength(length, rounds, gridSize);
+  if (out.size() < size) throw std::length_error("output buffer smaller than encryptedSize()");
+
+  letters.fillLetters(out.data(), size);
+
+  // the message is prepared on the fly, every kept character goes straight to its final position.
+  // long messages are mapped with RoundChain, a cached table for them would cost 4 bytes a character
+  const auto plan = length <= ComposedPlan::largestTable ? ComposedPlan::forEncryption(length, rounds, gridSize) : nullptr;
+  const RoundChain chain = plan ? RoundChain::forEncryption(0, 0) : RoundChain::forEncryption(length, rounds, gridSize);
+  const auto place = [&](const std::size_t index, const char ch) {
+    const std::uint64_t position = plan ? ((*plan)[index] == ComposedPlan::dropped ? RoundChain::dropped : (*plan)[index])
+                                        : chain.encryptedPosition(index);
+    if (position != RoundChain::dropped) out[position] = ch;
+  };
+  std::size_t index = 0;
+  char last = '\0';
+  for (const char c : message) {
+    if (Encryptor::keeps(c)) {
+      place(index++, static_cast<char>(std::toupper(static_cast<unsigned char>(c))));
+      last = c;
+    }
+  }
+  if (last != '.') place(index, '.');
+  return size;
+}
+
+std::size_t DiamondCipher::decryptedSize(const std::span<const char> encrypted) const {
+  return RoundChain::forDecryption(encrypted.size(), rounds).getOutputLength();
+}
+
+std::size_t DiamondCipher::decrypt(const std::span<const char> encrypted, const std::span<char> out) const {
+  const auto plan = encrypted.size() <= ComposedPlan::largestTable ? ComposedPlan::forDecryption(encrypted.size(), rounds) : nullptr;
+  const RoundChain chain = RoundChain::forDecryption(plan ? 0 : encrypted.size(), plan ? 0 : rounds);
+  if (!plan && !chain.isValid()) throw std::invalid_argument("input length is not a diamond ciphertext");
+  const std::size_t length = plan ? plan->getOutputLength() : chain.getOutputLength();
+
+  std::size_t written = 0;
+  while (written < length) {
+    if (written >= out.size()) throw std::length_error("output buffer smaller than decryptedSize()");
+    const std::size_t source = plan ? (*plan)[written] : chain.sourcePosition(written);
+    const char c = encrypted[source];
+    if (c == ' ') throw std::invalid_argument("ciphertext contains blank cells");
+    out[written++] = c;
+    if (c == '.') break; // everything after the first period is padding
+  }
+  return written;
+}
@@ -0,0 +1,53 @@
+/*
+ DiamondCipher is the public API of the diamond_core library.
+ it works on caller-provided buffers only, never prints, and tells the caller the
+ buffer size it needs up front. inputs up to ComposedPlan::largestTable characters go
+ through a cached index plan, once it exists encrypting and decrypting that length
+ do not allocate (building it the first time does). longer inputs build no table:
+ every position is worked out with RoundChain, which only allocates its list of round
+ grid sizes per call.
+
+   DiamondCipher cipher(0, 3);                       // automatic grids, 3 rounds
+   std::vector<char> out(cipher.encryptedSize(in));
+   cipher.encrypt(in, out);
+
+ invalid arguments (too small output, input that isn't a ciphertext of this cipher)
+ throw std::invalid_argument / std::length_error.
+ */
+
+#ifndef DIAMONDCIPHER_HPP
+#define DIAMONDCIPHER_HPP
+#include "PaddingGenerator.hpp"
+#include <cstddef> // size_t
+#include <cstdint> // seeds
+#include <span> // caller buffers
+
+class DiamondCipher {
+public:
+  DiamondCipher(int gridSize, int rounds); // gridSize <= 0 picks every round's grid automatically
+  DiamondCipher(int gridSize, int rounds, std::uint64_t seed); // deterministic padding
+
+  [[nodiscard]] std::size_t encryptedSize(std::span<const char> message) const;
+    // exact ciphertext length for this message (after preparing it: letters and '.', upper case, ending in '.')
+  std::size_t encrypt(std::span<const char> message, std::span<char> out);
+    // writes the ciphertext to out (at least encryptedSize(message) bytes) and returns its length
+  std::size_t encrypt(std::span<const char> message, std::span<char> out, PaddingGenerator& padding) const;
+    // same, with the caller's padding source (one per thread)
+
+  [[nodiscard]] std::size_t decryptedSize(std::span<const char> encrypted) const;
+    // bytes decrypt() may need: the plaintext before trimming at the first '.'
+  std::size_t decrypt(std::span<const char> encrypted, std::span<char> out) const;
+    // writes the plaintext up to and including the first '.' to out and returns its length
+
+  [[nodiscard]] int getRounds() const { return rounds; }
+  [[nodiscard]] int getGridSize() const { return gridSize; }
+
+private:
+  void validate() const;
+
+  int gridSize;
+  int rounds;
+  XoshiroPadding padding;
+};
+
+#endif //DIAMONDCIPHER_HPP
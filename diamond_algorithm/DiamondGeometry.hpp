@@ -0,0 +1,219 @@
+/*
+ DiamondGeometry answers the layout questions of the diamond path in O(1) with exact integer math.
+ for an odd grid of size n = 2c + 1, layer L (0 = outermost) is the ring of cells at
+ distance m = c - L from the center. its path starts at the middle of the left edge and
+ has 4m cells (1 for the center), so layer L starts at message offset 2L(n - L).
+ along a layer, position k walks the same four diagonals as Cycle::getDiamondPath:
+   k in [0, m]        up-right    (c - k, L + k)
+   k in (m, 2m]       down-right  (L + 1 + k', c + 1 + k')     k' = k - m - 1
+   k in (2m, 3m]      down-left   (c + 1 + k', 2c - 1 - L - k') k' = k - 2m - 1
+   k in (3m, 4m)      up-left     (2c - 1 - L - k', c - 1 - k') k' = k - 3m - 1
+ */
+
+#ifndef DIAMONDGEOMETRY_HPP
+#define DIAMONDGEOMETRY_HPP
+#include <array> // layer runs
+#include <cmath> // fast path of isqrt
+#include <cstdint> // 64 bit sizes
+#include <type_traits> // is_constant_evaluated
+
+class DiamondGeometry {
+public:
+  struct Cell {
+    int row;
+    int col;
+    constexpr bool operator==(const Cell&) const = default;
+  };
+
+  // one diagonal run of a layer: length cells from start, stepping (rowStep, colStep)
+  struct Run {
+    Cell start;
+    int rowStep;
+    int colStep;
+    int length;
+  };
+
+  // floor(sqrt(n)), exact for every 64 bit value
+  static constexpr std::uint64_t isqrt(const std::uint64_t n) {
+    if (!std::is_constant_evaluated()) {
+      // at run time start from the hardware square root and correct the rounding
+      constexpr std::uint64_t largest = 0xFFFFFFFFu;
+      std::uint64_t root = static_cast<std::uint64_t>(std::sqrt(static_cast<double>(n)));
+      if (root > largest) root = largest;
+      while (root * root > n) --root;
+      while (root < largest && (root + 1) * (root + 1) <= n) ++root;
+      return root;
+    }
+    std::uint64_t root = 0;
+    for (std::uint64_t bit = std::uint64_t{1} << 31; bit > 0; bit >>= 1) {
+      if (const std::uint64_t next = root | bit; next * next <= n) root = next;
+    }
+    return root;
+  }
+
+  // cells on the diamond of an odd grid, 1 + 2C(C+1) with C = size / 2
+  static constexpr std::uint64_t capacity(const int size) {
+    const std::uint64_t c = size / 2;
+    return 1 + 2 * c * (c + 1);
+  }
+
+  static constexpr int layers(const int size) { return (size + 1) / 2; }
+
+  static constexpr std::uint64_t layerLength(const int size, const int layer) {
+    const int m = size / 2 - layer;
+    return m == 0 ? 1 : 4 * static_cast<std::uint64_t>(m);
+  }
+
+  // message index of the first cell of a layer
+  static constexpr std::uint64_t layerOffset(const int size, const int layer) {
+    return 2 * static_cast<std::uint64_t>(layer) * static_cast<std::uint64_t>(size - layer);
+  }
+
+  // layer holding message index (index < capacity(size))
+  static constexpr int layerOf(const int size, const std::uint64_t index) {
+    // largest L with 2L(n - L) <= index, i.e. L <= (n - sqrt(n^2 - 2 index)) / 2
+    const std::uint64_t n = size;
+    const std::uint64_t square = n * n;
+    const std::uint64_t root = 2 * index >= square ? 0 : isqrt(square - 2 * index);
+    int layer = static_cast<int>((n - root) / 2);
+    const int last = size / 2;
+    if (layer > last) layer = last;
+    while (layer < last && layerOffset(size, layer + 1) <= index) ++layer; // isqrt rounding, at most one step
+    while (layer > 0 && layerOffset(size, layer) > index) --layer;
+    return layer;
+  }
+
+  // (row, col) of message index along the diamond path
+  static constexpr Cell cellOf(const int size, const std::uint64_t index) {
+    const int c = size / 2;
+    const int layer = layerOf(size, index);
+    const int m = c - layer;
+    const int k = static_cast<int>(index - layerOffset(size, layer));
+    if (k <= m) return {c - k, layer + k};
+    if (k <= 2 * m) return {layer + 1 + (k - m - 1), c + 1 + (k - m - 1)};
+    if (k <= 3 * m) return {c + 1 + (k - 2 * m - 1), 2 * c - 1 - layer - (k - 2 * m - 1)};
+    return {2 * c - 1 - layer - (k - 3 * m - 1), c - 1 - (k - 3 * m - 1)};
+  }
+
+  // the four diagonal runs of a layer in path order (up-right, down-right, down-left, up-left),
+  // same cells as cellOf for the layer's indices. the center layer is a single cell
+  static constexpr std::array<Run, 4> layerRuns(const int size, const int layer) {
+    const int c = size / 2;
+    const int m = c - layer;
+    if (m == 0) return {{{{c, c}, -1, 1, 1}, {{c, c}, 1, 1, 0}, {{c, c}, 1, -1, 0}, {{c, c}, -1, -1, 0}}};
+    return {{{{c, layer}, -1, 1, m + 1},
+             {{layer + 1, c + 1}, 1, 1, m},
+             {{c + 1, 2 * c - 1 - layer}, 1, -1, m},
+             {{2 * c - 1 - layer, c - 1}, -1, -1, m - 1}}};
+  }
+
+  // message index of (row, col), or -1 for the corner cells that are not on the diamond
+  static constexpr std::int64_t indexOf(const int size, const int row, const int col) {
+    const int c = size / 2;
+    const int m = (row > c ? row - c : c - row) + (col > c ? col - c : c - col);
+    if (m > c || row < 0 || col < 0 || row >= size || col >= size) return -1;
+    const int layer = c - m;
+    const auto offset = static_cast<std::int64_t>(layerOffset(size, layer));
+    if (row <= c && col <= c) return offset + (c - row); // up-right run, includes the start and top cells
+    if (row <= c) return offset + m + 1 + (col - c - 1); // down-right run
+    if (col >= c) return offset + 2 * m + 1 + (row - c - 1); // down-left run
+    return offset + 3 * m + 1 + (c - 1 - col); // up-left run
+  }
+
+  // walks one layer in path order and calls visit(row, col) for every cell, the walk of Cycle::getDiamondPath.
+  // usable at compile time, so fixed size tables can be generated from the same steps (FixedKernels.hpp)
+  template <typename Visit>
+  static constexpr void walkLayer(const int size, const int layer, Visit&& visit) {
+    const int center = size / 2;
+
+    // starting point (middle of left column for this layer)
+    const int startRow = center; // 3 for a 7x7
+    const int startCol = layer; // 0 for outermost layer
+
+    //Phase 1: Upward-right diagonal traversal.
+    int row = startRow; // 3
+    int col = startCol; // 0
+    while (col <= center) { // continue to center column
+      visit(row, col);
+      --row; // move one row up
+      ++col; // move one column right
+    }
+    // after loop: row = -1, col = 4 (reached diamond's top center)
+
+    //Phase 2: Downward-right diagonal traversal.
+    row += 2; // adjust row for next diagonal, now at row = 1, col = 4
+    while (col < size - layer) { // continue to right edge
+      visit(row, col);
+      ++row;
+      ++col;
+    }
+    // after loop: row = 3, col = 6 (diamond's right center)
+
+    // Phase 3: Down-left diagonal (from right-center edge to bottom-center)
+    col -= 2; // move col left by 2 (from 6 to 4), now at row = 3, col = 4
+    while (row < size - layer) { // go to bottom center
+      visit(row, col);
+      ++row;
+      --col;
+    }
+    // after loop: row = 6, col = 1 (bottom center)
+
+    // Phase 4: Up-left diagonal (from bottom-center back to starting point)
+    row -= 2; // adjust row upward (from 6 to 4), now at row = 4, col = 1
+    while (col > layer && row > startRow) { // traverse till starting point
+      visit(row, col);
+      --row;
+      --col;
+    }
+  }
+
+  // smallest odd grid whose diamond holds length characters (Encryptor::calculateGridSize)
+  static constexpr int gridSizeFor(const std::uint64_t length) {
+    if (length <= 1) return 1;
+    // 1 + 2C(C+1) >= length  <=>  C >= (sqrt(2 length - 1) - 1) / 2
+    std::uint64_t C = (isqrt(2 * length - 1) - 1) / 2;
+    while (1 + 2 * C * (C + 1) < length) ++C;
+    while (C > 0 && 1 + 2 * (C - 1) * C >= length) --C;
+    return static_cast<int>(2 * C + 1);
+  }
+
+  // ciphertext length after encrypting length characters for rounds rounds (gridSize <= 0 = automatic grids)
+  static constexpr std::uint64_t encryptedLength(std::uint64_t length, const int rounds, const int gridSize = 0) {
+    for (int round = 0; round < rounds; ++round) {
+      const std::uint64_t size = gridSize > 0 ? gridSize : gridSizeFor(length);
+      length = size * size;
+    }
+    return length;
+  }
+
+  // grid size the decryptor reads from a ciphertext of this length
+  static constexpr int gridSizeOfCipher(const std::uint64_t length) {
+    return static_cast<int>(isqrt(length));
+  }
+
+  // largest odd square <= length, at least 1 (the trim between decryption rounds, see nextRoundLength)
+  static constexpr std::uint64_t oddSquareTrim(const std::uint64_t length) {
+    std::uint64_t raw = isqrt(length);
+    if (raw % 2 == 0 && raw > 0) --raw;
+    if (raw == 0) raw = 1;
+    return raw * raw;
+  }
+
+  // what a decrypted round is cut to before the next one (Decryptor::prepareForNextRound): the odd square,
+  // but never longer than the round itself, a round that extracted nothing (all blank cells) stays empty
+  static constexpr std::uint64_t nextRoundLength(const std::uint64_t length) {
+    const std::uint64_t square = oddSquareTrim(length);
+    return square < length ? square : length;
+  }
+};
+
+static_assert(DiamondGeometry::capacity(7) == 25);
+static_assert(DiamondGeometry::gridSizeFor(25) == 7 && DiamondGeometry::gridSizeFor(26) == 9);
+static_assert(DiamondGeometry::cellOf(7, 0) == DiamondGeometry::Cell{3, 0});
+static_assert(DiamondGeometry::cellOf(7, 24) == DiamondGeometry::Cell{3, 3});
+static_assert(DiamondGeometry::indexOf(7, 0, 0) == -1);
+static_assert(DiamondGeometry::nextRoundLength(0) == 0 && DiamondGeometry::nextRoundLength(1) == 1); // blank ciphertexts extract nothing
+static_assert(DiamondGeometry::nextRoundLength(24) == 9 && DiamondGeometry::nextRoundLength(25) == 25);
+static_assert(DiamondGeometry::layerRuns(7, 1)[3].start == DiamondGeometry::cellOf(7, DiamondGeometry::layerOffset(7, 1) + 3 * 2 + 1));
+
+#endif //DIAMONDGEOMETRY_HPP
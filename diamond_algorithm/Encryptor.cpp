@@ -1,153 +1,316 @@
 #include "Encryptor.hpp"
 #include "Grid.hpp"
 #include "Cycle.hpp"
+#include "JobPlanner.hpp"
+#include "ComposedPlan.hpp"
+#include "DiamondCipher.hpp"
+#include "DiamondGeometry.hpp"
+#include "FixedKernels.hpp"
+#include "MappedFile.hpp"
+#include "RoundChain.hpp"
+#include "Trace.hpp"
+#include "PermutationPlan.hpp"
 #include <algorithm>
-#include <cmath>
-#include <iostream>
-#include <windows.h> // For SetConsoleTextAttribute
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
 
 Encryptor::Encryptor(const int gridSize, const int rounds)
-    : gridSize(gridSize), rounds(rounds) {}
+    : gridSize(gridSize), rounds(rounds), padding(std::make_unique<XoshiroPadding>()) {}
+
+void Encryptor::setPaddingGenerator(std::unique_ptr<PaddingGenerator> generator) {
+    padding = std::move(generator);
+}
+
+void Encryptor::setThreadPool(std::shared_ptr<ThreadPool> threadPool) {
+    pool = std::move(threadPool);
+}
+
+void Encryptor::setPaddingSeed(const std::uint64_t seed) {
+    padding = std::make_unique<XoshiroPadding>(seed);
+}
 
 std::string Encryptor::encrypt(std::string message) {
-    message = prepareMessage(message);
-    std::cout << "Prepared message: " << message << std::endl;
+    return encryptSinglePass(std::move(message)); // main encryption function that can handle multi rounds, prints nothing
+}
 
-    std::string encrypted = message;
-    for (int round = 0; round < rounds; ++round) {
-        displayRoundHeader(round + 1, encrypted);
-        encrypted = encryptCore(encrypted, true);
-        displayEncryptionResult(encrypted);
+std::string Encryptor::encryptSinglePass(std::string message) {
+    const Stats::Call call(stats, message.size());
+    {
+        const Stats::Timer timer(stats, Stats::Phase::Prepare);
+        message = prepareMessage(message);
     }
-    return encrypted; // main encryption function that can handle multi rounds
+    std::string encrypted = encryptPrepared(message, gridSize, *padding, stats);
+    call.setOutput(encrypted.size());
+    return encrypted;
 }
 
-std::string Encryptor::prepareMessage(const std::string& message) {
-    std::string prepared;
-    for (const char c : message) {
-        if (std::isalpha(static_cast<unsigned char>(c)) || c == '.') {
-            prepared += c;
-        }
+std::string Encryptor::encryptBlocks(std::string message, const int blockGridSize) {
+    if (blockGridSize <= 0 || blockGridSize % 2 == 0 || blockGridSize > largestBlockGridSize) {
+        throw std::invalid_argument("block grid size must be an odd number from 1 to " + std::to_string(largestBlockGridSize));
     }
-    std::ranges::transform(prepared, prepared.begin(), toupper);
-    if (prepared.empty() || prepared.back() != '.') {
-        prepared += '.';
+    const Stats::Call call(stats, message.size());
+    message = prepareMessage(message);
+    const std::string_view prepared = message;
+    const size_t blockCapacity = DiamondGeometry::capacity(blockGridSize); // fills the first grid exactly, no padding
+    const size_t blockCount = (prepared.size() + blockCapacity - 1) / blockCapacity;
+    const auto plainLength = [&](const size_t i) { return std::min(blockCapacity, prepared.size() - i * blockCapacity); };
+
+    // headers and ciphertext lengths follow from the block lengths alone, so the output is laid out first
+    // and every block is encrypted straight into its place
+    size_t total = 0;
+    for (size_t i = 0; i < blockCount; ++i) {
+        total += std::to_string(plainLength(i)).size() + 1 + DiamondGeometry::encryptedLength(plainLength(i), rounds);
     }
-    return prepared;
+    std::string encrypted;
+    encrypted.reserve(total);
+    std::vector<size_t> starts(blockCount); // where the ciphertext of each block begins
+    for (size_t i = 0; i < blockCount; ++i) {
+        encrypted += std::to_string(plainLength(i)); // header: plaintext length of the block
+        encrypted += ':';
+        starts[i] = encrypted.size();
+        encrypted.resize(encrypted.size() + DiamondGeometry::encryptedLength(plainLength(i), rounds));
+    }
+
+    // every block gets its own generator seeded from ours, with or without a pool:
+    // the output only depends on the seed, not on the thread count or the order the blocks finish in
+    std::vector<std::uint64_t> seeds(blockCount);
+    padding->fillBits(seeds.data(), seeds.size());
+    const auto encryptBlock = [&](const size_t i) {
+        XoshiroPadding blockPadding(seeds[i]);
+        encryptPreparedInto(prepared.substr(i * blockCapacity, blockCapacity), 0, blockPadding, encrypted.data() + starts[i]);
+    };
+    if (pool) {
+        pool->parallelFor(blockCount, encryptBlock);
+    } else {
+        for (size_t i = 0; i < blockCount; ++i) encryptBlock(i);
+    }
+    call.setOutput(encrypted.size());
+    return encrypted;
 }
 
-int Encryptor::calculateGridSize(const std::string& message) {
-    const int need = static_cast<int>(message.length()); // calculate length of input
-    // need represents min num of cells required in grid to hold all chars of message
-    int C = 0; // C is variable used to deriv grid formula
-    // helps find the right layer of diamond pattern
-    while (true) {
-        if (const int capacity = 1 + 2 * C * (C + 1); capacity >= need) return 2 * C + 1;
-        // capacity calculates how many cells a grid of specific size  can hold
-        // formula shows how the diamonds fill up.
-        // if grid can hold whole message, return
-        // grid size is always odd so we return it as 2*c + 1 to get grid length.
-        ++C; // if grid too small, we c inrease c to check next size
-    }
-}
-
-std::string Encryptor::encryptCore(const std::string& message, const bool verbose) {
-    const int size = gridSize <= 0 ? calculateGridSize(message) : gridSize;
-    if (verbose) {
-        usedGridSizes.push_back(size);
-        std::cout << "Grid size used: " << size << std::endl;
-    }
-
-    Grid grid(size);
-    int msgIndex = 0;
-    const int layers = (size + 1) / 2;
-    // make grid object with determiend layer
-    std::string allDiamondLetters, allOriginalLetters;
-
-    for (int layer = 0; layer < layers; ++layer) {
-        Cycle cycle(&grid, layer);
-        cycle.fillWithMessage(message, msgIndex);
-        // create cycle objects and fill grid with message
-        if (verbose) {
-            allDiamondLetters += cycle.getFullDiamondLetters();
-            allOriginalLetters += cycle.getOriginalMessageLetters();
+void Encryptor::encryptBatch(const std::span<const std::string_view> messages, std::string& arena, std::vector<size_t>& offsets) {
+    // every ciphertext length is known from the prepared length, so the arena is sized once up front
+    offsets.resize(messages.size() + 1);
+    offsets[0] = 0;
+    for (size_t i = 0; i < messages.size(); ++i) {
+        offsets[i + 1] = offsets[i] + DiamondGeometry::encryptedLength(preparedLength(messages[i]), rounds, gridSize);
+    }
+    arena.resize(offsets.back());
+
+    const auto encryptRange = [&](const size_t first, const size_t last, PaddingGenerator& letters) {
+        std::string prepared; // scratch, reused for every message of the range
+        std::unordered_map<size_t, std::shared_ptr<const ComposedPlan>> plans; // repeated lengths skip the shared cache
+        for (size_t i = first; i < last; ++i) {
+            prepareInto(messages[i], prepared);
+            char* out = arena.data() + offsets[i];
+            auto [found, added] = plans.try_emplace(prepared.size());
+            if (added) found->second = ComposedPlan::forEncryption(prepared.size(), rounds, gridSize);
+            if (const auto& plan = found->second) {
+                letters.fillLetters(out, plan->getOutputLength());
+                plan->scatter(prepared.data(), out); // straight into the arena
+            } else {
+                encryptPreparedInto(prepared, gridSize, letters, out);
+            }
         }
+    };
+
+    constexpr size_t chunk = 1024; // messages per parallel job
+    const size_t chunks = (messages.size() + chunk - 1) / chunk;
+    if (!pool || chunks <= 1) {
+        encryptRange(0, messages.size(), *padding);
+        return;
     }
+    std::vector<std::uint64_t> seeds(chunks); // one generator per job, same output for any thread count
+    padding->fillBits(seeds.data(), seeds.size());
+    pool->parallelFor(chunks, [&](const size_t job) {
+        XoshiroPadding letters(seeds[job]);
+        encryptRange(job * chunk, std::min(messages.size(), (job + 1) * chunk), letters);
+    });
+}
 
-    const Cycle finalCycle(&grid, 0);
-    finalCycle.fillEmptyCells();
+void Encryptor::encryptFile(const std::string& inputPath, const std::string& outputPath) {
+    const MappedFile input = MappedFile::openRead(inputPath, MappedFile::Access::Sequential);
+    const std::string_view text(input.data(), input.size());
+    const Stats::Call call(stats, text.size());
 
-    if (verbose) {
-        displayGridConstruction(grid, allOriginalLetters, allDiamondLetters);
+    if (rounds < 0 || (gridSize > 0 && gridSize % 2 == 0)) {
+        // DiamondCipher takes odd or automatic grids only, a fixed even grid has no closed form: encrypt in memory
+        const std::string encrypted = encrypt(std::string(text));
+        MappedFile output = MappedFile::create(outputPath, encrypted.size(), MappedFile::Access::Sequential);
+        std::copy(encrypted.begin(), encrypted.end(), output.data());
+        call.setOutput(encrypted.size());
+        return;
     }
 
-    return grid.getEncryptedMessage();
+    // the output size follows from the prepared length alone, so the file is created at its final size
+    // and DiamondCipher prepares the input on the fly, writing every character straight to its place
+    const DiamondCipher cipher(gridSize, rounds);
+    MappedFile output = MappedFile::create(outputPath, cipher.encryptedSize(text), MappedFile::Access::Random);
+    call.setOutput(output.size());
+    cipher.encrypt(text, {output.data(), output.size()}, *padding);
 }
 
-std::string Encryptor::encryptSingleRound(const std::string& message) {
-    return encryptCore(message, true);
+std::string Encryptor::encryptPrepared(const std::string_view message, const int size, PaddingGenerator& letters, Stats* record) {
+    if (size > 0 && size % 2 == 0) {
+        return encryptRounds(message, size, letters, record); // even grids have no plan, nothing to write in place
+    }
+    std::string encrypted(DiamondGeometry::encryptedLength(message.size(), rounds, size), ' ');
+    encryptPreparedInto(message, size, letters, encrypted.data(), record);
+    return encrypted;
 }
 
-std::string Encryptor::encryptWithDisplay(std::string message) {
-    message = prepareMessage(message);
-    std::cout << "\n=== STARTING ENCRYPTION PROCESS ===" << std::endl;
-    std::cout << "Initial message: " << message << std::endl << std::endl;
+void Encryptor::encryptPreparedInto(const std::string_view message, const int size, PaddingGenerator& letters, char* out,
+                                    Stats* record) {
+    DIAMOND_TRACE_SCOPE("Encryptor::encryptPrepared"); // one per block in block mode
+    if (const int single = size <= 0 ? DiamondGeometry::gridSizeFor(message.size()) : size; rounds == 1 && FixedKernels::supports(single)) {
+        // one small grid: the compile time kernel, no plan lookup
+        if (record) record->beginRound(single, message.size());
+        const size_t cells = static_cast<size_t>(single) * single;
+        {
+            const Stats::Timer timer(record, Stats::Phase::Pad);
+            letters.fillLetters(out, cells);
+        }
+        {
+            const Stats::Timer timer(record, Stats::Phase::Fill);
+            FixedKernels::scatter(single, message.data(), message.size(), out);
+        }
+        if (record) record->endRound(cells);
+        return;
+    }
+    // every round folded into one cached table of message positions while that table stays small,
+    // past ComposedPlan::largestTable the same positions come from RoundChain, one character at a time
+    std::shared_ptr<const ComposedPlan> plan;
+    std::optional<RoundChain> chain;
+    {
+        const Stats::Timer timer(record, Stats::Phase::PathBuild);
+        if (message.size() <= ComposedPlan::largestTable) plan = ComposedPlan::forEncryption(message.size(), rounds, size);
+        if (!plan) {
+            if (RoundChain built = RoundChain::forEncryption(message.size(), rounds, size); built.isValid()) chain.emplace(std::move(built));
+        }
+    }
+    if (!plan && !chain) {
+        const std::string encrypted = encryptRounds(message, size, letters, record);
+        std::copy(encrypted.begin(), encrypted.end(), out);
+        return;
+    }
+    if (record) {
+        // one pass for every round, the rounds only have their sizes
+        record->composed = true;
+        size_t length = message.size();
+        for (const int roundSize : plan ? plan->getGridSizes() : chain->getGridSizes()) {
+            record->beginRound(roundSize, length);
+            length = static_cast<size_t>(roundSize) * roundSize;
+            record->endRound(length);
+        }
+    }
+    // the final position of every message character depends only on (length, rounds),
+    // so pad the final-size buffer once and drop the message straight into place
+    {
+        const Stats::Timer timer(record, Stats::Phase::Pad);
+        letters.fillLetters(out, plan ? plan->getOutputLength() : chain->getOutputLength());
+    }
+    const Stats::Timer timer(record, Stats::Phase::Fill);
+    if (plan) plan->scatter(message.data(), out);
+    else chain->scatter(message.data(), out);
+}
 
-    std::string encrypted = message;
+std::string Encryptor::encryptRounds(const std::string_view message, const int size, PaddingGenerator& letters, Stats* record) {
+    // round by round over two buffers sized for the largest round, swapped after each round
+    std::string current, next;
+    reserveRounds(message.size(), size, current, next);
+    current.assign(message);
+    Grid grid(0); // only used for even grid sizes
     for (int round = 0; round < rounds; ++round) {
-        std::cout << "\n=== ROUND " << round + 1 << " ===" << std::endl;
-        encrypted = encryptCore(encrypted, true);
-        std::cout << "\nRound " << round + 1 << " complete!" << std::endl;
+        encryptIntoGrid(current, size <= 0 ? calculateGridSize(current) : size, letters, grid, next, record);
+        current.swap(next);
     }
-
-    std::cout << "\n=== FINAL RESULT ===" << std::endl;
-    // std::cout << "Full encrypted message: " << encrypted << std::endl;
-    return encrypted;
+    return current;
 }
 
-std::string Encryptor::multiRoundEncryptWithDisplay(const std::string& message) {
-    std::string current = prepareMessage(message);
-    std::cout << "Starting multi-round encryption (" << rounds << " rounds)\n";
-    std::cout << "Initial message: " << current << "\n";
+std::string Encryptor::prepareMessage(const std::string& message) {
+    std::string prepared;
+    prepareInto(message, prepared);
+    return prepared;
+}
 
-    for (int round = 1; round <= rounds; ++round) {
-        std::cout << "\n=== ROUND " << round << "/" << rounds << " ===\n";
-        current = encryptSingleRound(current);
-        std::cout << "Round " << round << " result: " << current << "\n";
+void Encryptor::prepareInto(const std::string_view message, std::string& prepared) {
+    prepared.clear(); // keeps the capacity, so a reused buffer stops allocating
+    for (const char c : message) {
+        if (keeps(c)) {
+            prepared += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        }
+    }
+    if (prepared.empty() || prepared.back() != '.') {
+        prepared += '.';
     }
+}
 
-    std::cout << "\n=== FINAL RESULT ===\n"
-              << "Total rounds: " << rounds << "\n"
-              << "Final length: " << current.size() << " chars\n";
+size_t Encryptor::preparedLength(const std::string_view message) {
+    size_t length = 0;
+    char last = '\0';
+    for (const char c : message) {
+        if (keeps(c)) {
+            ++length;
+            last = c;
+        }
+    }
+    return last == '.' ? length : length + 1; // prepareMessage adds the final '.' when it is missing
+}
 
-    return current;
+int Encryptor::calculateGridSize(const std::string& message) {
+    // smallest odd grid whose diamond (1 + 2C(C+1) cells) holds the whole message, solved in O(1)
+    return DiamondGeometry::gridSizeFor(message.length());
 }
 
-void Encryptor::displayGridConstruction(const Grid& grid, const std::string& originalLetters, const std::string& allDiamondLetters) {
-    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 2);
-    std::cout << "=== Original Message in Diamond Path ===\n"
-              << originalLetters << "\n"
-              << "Message Length: " << originalLetters.size() << "\n\n";
+void Encryptor::reserveRounds(const size_t length, const int size, std::string& current, std::string& next) const {
+    const JobPlan plan = JobPlanner::forEncryption(length, rounds, size);
+    if (plan.overflow) return; // the first round that can't be allocated throws, same as before
+    const size_t largest = std::max<size_t>(plan.largestOutput, length);
+    current.reserve(largest);
+    next.reserve(largest);
+}
 
-    std::cout << "=== Full Diamond Path Letters (Message + Random) ===\n"
-              << allDiamondLetters << "\n"
-              << "Total Length: " << allDiamondLetters.size() << "\n";
-    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 7);
+void Encryptor::encryptIntoGrid(const std::string& message, const int size, PaddingGenerator& letters,
+                                Grid& grid, std::string& encrypted, Stats* record) {
+    DIAMOND_TRACE_SCOPE("Encryptor::encryptIntoGrid");
+    if (record) record->beginRound(size, message.size());
+    if (size % 2 == 1) {
+        // odd grids: one scatter through a fixed size kernel or the cached plan, no Grid or Cycle objects
+        encrypted.resize(static_cast<size_t>(size) * size); // stays within the reserved capacity
+        {
+            const Stats::Timer timer(record, Stats::Phase::Pad);
+            letters.fillLetters(encrypted.data(), encrypted.size()); // padding for every cell the message does not reach
+        }
+        if (!FixedKernels::supports(size)) {
+            std::shared_ptr<const PermutationPlan> plan;
+            {
+                const Stats::Timer timer(record, Stats::Phase::PathBuild);
+                plan = PermutationPlan::forSize(size);
+            }
+            const Stats::Timer timer(record, Stats::Phase::Fill);
+            plan->scatter(message.data(), message.size(), encrypted.data());
+        } else {
+            const Stats::Timer timer(record, Stats::Phase::Fill);
+            FixedKernels::scatter(size, message.data(), message.size(), encrypted.data());
+        }
+        if (record) record->endRound(encrypted.size());
+        return;
+    }
 
-    std::cout << "\nFilled Grid:" << std::endl;
-    grid.display();
-}
+    grid.reset(size);
+    {
+        const Stats::Timer timer(record, Stats::Phase::Fill); // the layer paths are built inside the cycles
+        Cycle::fillLayers(grid, message, &letters);
+    }
+    {
+        const Stats::Timer timer(record, Stats::Phase::Pad);
+        Cycle(&grid, 0, &letters).fillEmptyCells();
+    }
 
-void Encryptor::displayRoundHeader(const int round, const std::string& message) {
-    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 2);
-    std::cout << "\nEncryption Round " << round << ":" << std::endl;
-    std::cout << "Processing message: " << message << std::endl;
-    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 7);
+    {
+        const Stats::Timer timer(record, Stats::Phase::Serialize);
+        grid.readEncrypted(encrypted);
+    }
+    if (record) record->endRound(encrypted.size());
 }
-
-void Encryptor::displayEncryptionResult(const std::string& encrypted) {
-    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 2);
-    std::cout << "Encrypted result:\n" << encrypted << std::endl
-              << "Length: " << encrypted.size() << std::endl;
-    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 7);
-}
\ No newline at end of file
@@ -1,36 +1,91 @@
 #ifndef ENCRYPTOR_HPP
 #define ENCRYPTOR_HPP
 
+#include <cctype>
+#include <cstdint>
+#include <memory>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
+#include "PaddingGenerator.hpp"
+#include "Stats.hpp"
+#include "ThreadPool.hpp"
 
 class Grid;
-class Cycle;
 
 class Encryptor {
 public:
     Encryptor(int gridSize, int rounds); // gridsize: the size of the grid to use for encryption.
     // rounds:   the number of encryption rounds to perform.
 
+    // padding
+    void setPaddingGenerator(std::unique_ptr<PaddingGenerator> generator); // replaces the default random source
+    void setPaddingSeed(std::uint64_t seed); // deterministic padding, same seed gives the same ciphertext
+    void setThreadPool(std::shared_ptr<ThreadPool> threadPool); // spreads blocks over the pool, nullptr = calling thread only
+    void setStats(Stats* target) { stats = target; } // filled in by every call, nullptr (the default) measures nothing.
+    // blocks and files only get totals, bytes and allocations, batches are not measured
+
     // core functionality
     std::string encrypt(std::string message);
+    std::string encryptSinglePass(std::string message); // all rounds as one scatter into the final-size output
+    std::string encryptBlocks(std::string message, int blockGridSize);
+    // block mode for large inputs: the prepared message is cut into blocks of exactly
+    // 1 + 2C(C+1) characters (the diamond of a blockGridSize = 2C+1 grid, the last block may be shorter),
+    // each block is encrypted on its own with automatic grids and written as "<plaintext length>:<ciphertext>".
+    // memory per block stays the same however long the message is. Decryptor::decryptBlocks reverses it.
+    // every block pads from a generator seeded from this one, so a thread pool (which encrypts the blocks
+    // in parallel) gives the same ciphertext. blockGridSize is at most largestBlockGridSize.
+    static constexpr int largestBlockGridSize = 4095; // about 8.4 million characters a block, Decryptor::decryptBlocks rejects longer ones
+    void encryptBatch(std::span<const std::string_view> messages, std::string& arena, std::vector<size_t>& offsets);
+    // encrypts many messages into one caller-owned arena: message i ends up in
+    // arena[offsets[i], offsets[i + 1]). the arena is sized once, scratch buffers and plans are
+    // reused across the batch, and reusing the same arena/offsets between calls avoids reallocating.
+    // with a thread pool the batch is split into jobs, each with a generator seeded from this one.
+    void encryptFile(const std::string& inputPath, const std::string& outputPath);
+    // encrypts a whole file as one message through memory mappings and DiamondCipher: the output file is
+    // created at its final size and every character is written straight to its place. past
+    // ComposedPlan::largestTable characters no table is built, so peak memory is about the output size.
+    // throws std::runtime_error on I/O errors.
+
+    // console output (EncryptorDisplay.cpp, only built into the interactive program)
     std::string encryptSingleRound(const std::string& message);
+    std::string encryptCore(const std::string& message, bool verbose); // core encryption logic with verbose for more detail
     std::string encryptWithDisplay(std::string message); // displays step by step process
     std::string multiRoundEncryptWithDisplay(const std::string& message); // displays multi round step by step
 
     // helper methods
     static std::string prepareMessage(const std::string& message); // cleans encryption
+    static void prepareInto(std::string_view message, std::string& prepared); // same, into a reusable buffer
+    static size_t preparedLength(std::string_view message); // length prepareMessage would return, without building it
     static int calculateGridSize(const std::string& message);
-    std::string encryptCore(const std::string& message, bool verbose); // core encryption logic with verbose for more detail
+    static bool keeps(const char c) { return std::isalpha(static_cast<unsigned char>(c)) || c == '.'; }
+    // true for the characters prepareMessage keeps (letters and '.')
 
-    // display methods
+    // display methods (EncryptorDisplay.cpp)
     static void displayGridConstruction(const Grid& grid,const std::string& originalLetters, const std::string& allDiamondLetters); // grid construction details
     static void displayRoundHeader(int round, const std::string& message);
     static void displayEncryptionResult(const std::string& encrypted);
 
 private:
+    std::string encryptPrepared(std::string_view message, int size, PaddingGenerator& letters, Stats* record = nullptr);
+    // all rounds of an already prepared message. record is nullptr inside blocks and batches, they run on many threads
+    void encryptPreparedInto(std::string_view message, int size, PaddingGenerator& letters, char* out, Stats* record = nullptr);
+    // same, into out, which holds DiamondGeometry::encryptedLength(message.size(), rounds, size) bytes
+    std::string encryptRounds(std::string_view message, int size, PaddingGenerator& letters, Stats* record = nullptr);
+    // the round by round engine, for grids no plan covers
+    void encryptIntoGrid(const std::string& message, int size, PaddingGenerator& letters, Grid& grid, std::string& encrypted,
+                         Stats* record = nullptr);
+    // one round on a grid of the given size into encrypted. grid is scratch for the Cycle path, reused between rounds
+    void encryptIntoGridWithDisplay(const std::string& message, int size, PaddingGenerator& letters, Grid& grid,
+                                    std::string& encrypted, Stats* record = nullptr);
+    // same round always through the Cycles, printing every step (EncryptorDisplay.cpp)
+    void reserveRounds(size_t length, int size, std::string& current, std::string& next) const;
+    // sizes both round buffers for the largest round of a length character message
     int gridSize;
     int rounds;
-    std::vector<int> usedGridSizes;
+    std::unique_ptr<PaddingGenerator> padding; // seeded once, shared by every round
+    std::shared_ptr<ThreadPool> pool; // optional, shared with other engines
+    Stats* stats = nullptr; // not owned
 };
 #endif
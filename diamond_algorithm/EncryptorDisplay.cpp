@@ -0,0 +1,136 @@
+#include "Encryptor.hpp"
+#include "Grid.hpp"
+#include "Cycle.hpp"
+#include "GridObserver.hpp"
+#include "Trace.hpp"
+#include <iostream>
+#include <windows.h> // For SetConsoleTextAttribute
+
+// the printing half of Encryptor. Encryptor.cpp never writes to the console, so it is part of
+// diamond_core, this file is only built into the interactive program
+
+std::string Encryptor::encryptSingleRound(const std::string& message) {
+    return encryptCore(message, true);
+}
+
+std::string Encryptor::encryptCore(const std::string& message, const bool verbose) {
+    DIAMOND_TRACE_SCOPE("Encryptor::encryptCore");
+    const Stats::Call call(stats, message.size());
+    Grid grid(0);
+    std::string encrypted;
+    const int size = gridSize <= 0 ? calculateGridSize(message) : gridSize;
+    if (verbose) {
+        encryptIntoGridWithDisplay(message, size, *padding, grid, encrypted, stats);
+    } else {
+        encryptIntoGrid(message, size, *padding, grid, encrypted, stats);
+    }
+    call.setOutput(encrypted.size());
+    return encrypted;
+}
+
+void Encryptor::encryptIntoGridWithDisplay(const std::string& message, const int size, PaddingGenerator& letters,
+                                           Grid& grid, std::string& encrypted, Stats* record) {
+    DIAMOND_TRACE_SCOPE("Encryptor::encryptIntoGridWithDisplay");
+    if (record) record->beginRound(size, message.size());
+    std::cout << "Grid size used: " << size << std::endl;
+
+    grid.reset(size);
+    std::string allDiamondLetters, allOriginalLetters;
+    {
+        const Stats::Timer timer(record, Stats::Phase::Fill);
+        // the console policy animates every cell write
+        BasicCycle<ConsoleGridObserver>::fillLayers(grid, message, &letters, &allOriginalLetters, &allDiamondLetters);
+    }
+    {
+        const Stats::Timer timer(record, Stats::Phase::Pad);
+        BasicCycle<ConsoleGridObserver>(&grid, 0, &letters).fillEmptyCells();
+    }
+    displayGridConstruction(grid, allOriginalLetters, allDiamondLetters);
+
+    {
+        const Stats::Timer timer(record, Stats::Phase::Serialize);
+        grid.readEncrypted(encrypted);
+    }
+    if (record) record->endRound(encrypted.size());
+}
+
+std::string Encryptor::encryptWithDisplay(std::string message) {
+    const Stats::Call call(stats, message.size());
+    {
+        const Stats::Timer timer(stats, Stats::Phase::Prepare);
+        message = prepareMessage(message);
+    }
+    std::cout << "\n=== STARTING ENCRYPTION PROCESS ===" << std::endl;
+    std::cout << "Initial message: " << message << std::endl << std::endl;
+
+    std::string encrypted = std::move(message), next;
+    reserveRounds(encrypted.size(), gridSize, encrypted, next);
+    Grid grid(0);
+    for (int round = 0; round < rounds; ++round) {
+        std::cout << "\n=== ROUND " << round + 1 << " ===" << std::endl;
+        encryptIntoGridWithDisplay(encrypted, gridSize <= 0 ? calculateGridSize(encrypted) : gridSize, *padding, grid, next, stats);
+        encrypted.swap(next);
+        std::cout << "\nRound " << round + 1 << " complete!" << std::endl;
+    }
+
+    std::cout << "\n=== FINAL RESULT ===" << std::endl;
+    // std::cout << "Full encrypted message: " << encrypted << std::endl;
+    call.setOutput(encrypted.size());
+    return encrypted;
+}
+
+std::string Encryptor::multiRoundEncryptWithDisplay(const std::string& message) {
+    const Stats::Call call(stats, message.size());
+    std::string current, next;
+    {
+        const Stats::Timer timer(stats, Stats::Phase::Prepare);
+        current = prepareMessage(message);
+    }
+    std::cout << "Starting multi-round encryption (" << rounds << " rounds)\n";
+    std::cout << "Initial message: " << current << "\n";
+
+    reserveRounds(current.size(), gridSize, current, next);
+    Grid grid(0);
+    for (int round = 1; round <= rounds; ++round) {
+        std::cout << "\n=== ROUND " << round << "/" << rounds << " ===\n";
+        encryptIntoGridWithDisplay(current, gridSize <= 0 ? calculateGridSize(current) : gridSize, *padding, grid, next, stats);
+        current.swap(next);
+        std::cout << "Round " << round << " result: " << current << "\n";
+    }
+
+    std::cout << "\n=== FINAL RESULT ===\n"
+              << "Total rounds: " << rounds << "\n"
+              << "Final length: " << current.size() << " chars\n";
+
+    call.setOutput(current.size());
+    return current;
+}
+
+void Encryptor::displayGridConstruction(const Grid& grid, const std::string& originalLetters, const std::string& allDiamondLetters) {
+    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 2);
+    std::cout << "=== Original Message in Diamond Path ===\n"
+              << originalLetters << "\n"
+              << "Message Length: " << originalLetters.size() << "\n\n";
+
+    std::cout << "=== Full Diamond Path Letters (Message + Random) ===\n"
+              << allDiamondLetters << "\n"
+              << "Total Length: " << allDiamondLetters.size() << "\n";
+    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 7);
+
+    std::cout << "\nFilled Grid:" << std::endl;
+    grid.display(std::cout);
+}
+
+void Encryptor::displayRoundHeader(const int round, const std::string& message) {
+    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 2);
+    std::cout << "\nEncryption Round " << round << ":" << std::endl;
+    std::cout << "Processing message: " << message << std::endl;
+    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 7);
+}
+
+void Encryptor::displayEncryptionResult(const std::string& encrypted) {
+    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 2);
+    std::cout << "Encrypted result:\n" << encrypted << std::endl
+              << "Length: " << encrypted.size() << std::endl;
+    SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 7);
+}
\ No newline at end of file
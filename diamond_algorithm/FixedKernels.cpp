@@ -0,0 +1,179 @@
+#include "FixedKernels.hpp"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#if defined(__AVX2__) || defined(__SSSE3__)
+#include <immintrin.h>
+#define DIAMOND_SHUFFLE_KERNELS 1
+#endif
+
+namespace {
+#ifdef DIAMOND_SHUFFLE_KERNELS
+  // small grids fit in a few 16 byte registers: each 16 byte chunk of the output is the OR
+  // of one pshufb per 16 byte block of the input, with 0x80 (zero) for cells that live in
+  // another block. the last block and chunk start 16 bytes before the end and overlap the
+  // previous one, so no partial loads or stores are needed. the controls come from
+  // FixedKernel<N>::positions at compile time. below 7x7 a diamond is shorter than one
+  // register, and past 9x9 the shuffle count (blocks * chunks) loses to the unrolled scalar kernel
+  constexpr int smallestShuffle = 7;
+  constexpr int largestShuffle = 9;
+
+  template <int N>
+  struct ShuffleKernel {
+    using Fixed = FixedKernel<N>;
+    static constexpr std::size_t cells = static_cast<std::size_t>(N) * N;
+    static constexpr std::size_t cellBlocks = (cells + 15) / 16;
+    static constexpr std::size_t pathBlocks = (Fixed::capacity + 15) / 16;
+    static_assert(Fixed::capacity >= 16, "a diamond has to fill at least one register");
+    using Control = std::array<std::uint8_t, 16>;
+
+    static constexpr std::size_t cellBase(const std::size_t b) { return std::min(16 * b, cells - 16); }
+    static constexpr std::size_t pathBase(const std::size_t b) { return std::min(16 * b, Fixed::capacity - 16); }
+
+    // path index of every grid cell, -1 for the corners
+    static constexpr auto pathIndex = [] {
+      std::array<int, cells> index{};
+      index.fill(-1);
+      for (std::size_t i = 0; i < Fixed::capacity; ++i) index[Fixed::positions[i]] = static_cast<int>(i);
+      return index;
+    }();
+
+    // [path chunk][grid block]: lane of grid block b holding path cell pathBase(c) + k
+    static constexpr auto gatherControl = [] {
+      std::array<std::array<Control, cellBlocks>, pathBlocks> control{};
+      for (std::size_t c = 0; c < pathBlocks; ++c) {
+        for (std::size_t b = 0; b < cellBlocks; ++b) {
+          for (std::size_t k = 0; k < 16; ++k) {
+            const std::size_t position = Fixed::positions[pathBase(c) + k];
+            // a cell covered by two overlapping blocks is taken from the first one only
+            const bool here = position / 16 == b || (b + 1 == cellBlocks && position >= 16 * b);
+            control[c][b][k] = here ? static_cast<std::uint8_t>(position - cellBase(b)) : 0x80;
+          }
+        }
+      }
+      return control;
+    }();
+
+    // [grid chunk][path block]: lane of path block b holding the message character of grid cell cellBase(c) + k
+    static constexpr auto scatterControl = [] {
+      std::array<std::array<Control, pathBlocks>, cellBlocks> control{};
+      for (std::size_t c = 0; c < cellBlocks; ++c) {
+        for (std::size_t b = 0; b < pathBlocks; ++b) {
+          for (std::size_t k = 0; k < 16; ++k) {
+            const int i = pathIndex[cellBase(c) + k];
+            const auto index = static_cast<std::size_t>(i);
+            const bool here = i >= 0 && (index / 16 == b || (b + 1 == pathBlocks && index >= 16 * b));
+            control[c][b][k] = here ? static_cast<std::uint8_t>(index - pathBase(b)) : 0x80;
+          }
+        }
+      }
+      return control;
+    }();
+
+    // 0xFF where grid chunk c is a diamond cell, the corners keep their padding
+    static constexpr auto onDiamond = [] {
+      std::array<Control, cellBlocks> mask{};
+      for (std::size_t c = 0; c < cellBlocks; ++c) {
+        for (std::size_t k = 0; k < 16; ++k) mask[c][k] = pathIndex[cellBase(c) + k] >= 0 ? 0xFF : 0;
+      }
+      return mask;
+    }();
+
+    // replays the gather shuffles at compile time and compares them with the scalar table
+    static constexpr bool controlsMatch() {
+      for (std::size_t c = 0; c < pathBlocks; ++c) {
+        for (std::size_t k = 0; k < 16; ++k) {
+          std::size_t hits = 0;
+          for (std::size_t b = 0; b < cellBlocks; ++b) {
+            const std::uint8_t lane = gatherControl[c][b][k];
+            if (lane == 0x80) continue;
+            if (lane > 15 || cellBase(b) + lane != Fixed::positions[pathBase(c) + k]) return false;
+            ++hits;
+          }
+          if (hits != 1) return false;
+        }
+      }
+      return true;
+    }
+    static_assert(controlsMatch(), "shuffle controls differ from the diamond path");
+
+    static __m128i load(const void* from) { return _mm_loadu_si128(static_cast<const __m128i*>(from)); }
+    static void store(void* to, const __m128i value) { _mm_storeu_si128(static_cast<__m128i*>(to), value); }
+
+    static void gather(const char* encrypted, char* out) {
+      __m128i blocks[cellBlocks];
+      for (std::size_t b = 0; b < cellBlocks; ++b) blocks[b] = load(encrypted + cellBase(b));
+      for (std::size_t c = 0; c < pathBlocks; ++c) {
+        __m128i chunk = _mm_setzero_si128();
+        for (std::size_t b = 0; b < cellBlocks; ++b) {
+          chunk = _mm_or_si128(chunk, _mm_shuffle_epi8(blocks[b], load(gatherControl[c][b].data())));
+        }
+        store(out + pathBase(c), chunk);
+      }
+    }
+
+    // out already holds padding in every cell. a message shorter than the diamond
+    // would need partial loads, the scalar kernel handles it
+    static void scatter(const char* message, const std::size_t length, char* out) {
+      if (length < Fixed::capacity) {
+        Fixed::scatter(message, length, out);
+        return;
+      }
+      __m128i blocks[pathBlocks];
+      for (std::size_t b = 0; b < pathBlocks; ++b) blocks[b] = load(message + pathBase(b));
+      for (std::size_t c = 0; c < cellBlocks; ++c) {
+        __m128i chunk = _mm_setzero_si128();
+        for (std::size_t b = 0; b < pathBlocks; ++b) {
+          chunk = _mm_or_si128(chunk, _mm_shuffle_epi8(blocks[b], load(scatterControl[c][b].data())));
+        }
+        const __m128i diamond = load(onDiamond[c].data());
+        const __m128i current = load(out + cellBase(c));
+        store(out + cellBase(c), _mm_or_si128(_mm_and_si128(diamond, chunk), _mm_andnot_si128(diamond, current)));
+      }
+    }
+  };
+#endif
+
+  struct Entry {
+    void (*scatter)(const char*, std::size_t, char*) = nullptr;
+    void (*gather)(const char*, char*) = nullptr;
+  };
+  using Table = std::array<Entry, FixedKernels::largest + 1>; // indexed by grid size, even sizes stay empty
+
+  template <int N>
+  constexpr Entry entryFor() {
+#ifdef DIAMOND_SHUFFLE_KERNELS
+    if constexpr (N >= smallestShuffle && N <= largestShuffle) return {&ShuffleKernel<N>::scatter, &ShuffleKernel<N>::gather};
+#endif
+    return {&FixedKernel<N>::scatter, &FixedKernel<N>::gather};
+  }
+
+  template <std::size_t... I>
+  constexpr Table makeTable(std::index_sequence<I...>) {
+    Table table{};
+    ((table[2 * I + FixedKernels::smallest] = entryFor<2 * I + FixedKernels::smallest>()), ...);
+    return table;
+  }
+
+  constexpr Table table = makeTable(std::make_index_sequence<(FixedKernels::largest - FixedKernels::smallest) / 2 + 1>{});
+
+  const Entry* find(const int size) {
+    if (!FixedKernels::supports(size)) return nullptr;
+    return &table[size];
+  }
+}
+
+bool FixedKernels::scatter(const int size, const char* message, const std::size_t length, char* out) {
+  const Entry* entry = find(size);
+  if (!entry) return false;
+  entry->scatter(message, length, out);
+  return true;
+}
+
+bool FixedKernels::gather(const int size, const char* encrypted, char* out) {
+  const Entry* entry = find(size);
+  if (!entry) return false;
+  entry->gather(encrypted, out);
+  return true;
+}
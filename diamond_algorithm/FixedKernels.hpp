@@ -0,0 +1,72 @@
+/*
+ FixedKernels are scatter/gather kernels specialised for one grid size at compile time.
+ most messages fit grids of 3 to 63, for those the diamond permutation is a constexpr
+ std::array generated by DiamondGeometry::walkLayer (the walk of Cycle::getDiamondPath),
+ so the loop bounds are constants the compiler can unroll and vectorize.
+ FixedKernels::scatter/gather pick the kernel through a table and return false for any
+ other size, callers then fall back to PermutationPlan. builds with SSSE3 or AVX2 use
+ pshufb shuffle kernels for 7x7 and 9x9 instead (FixedKernels.cpp).
+ */
+
+#ifndef FIXEDKERNELS_HPP
+#define FIXEDKERNELS_HPP
+#include "DiamondGeometry.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+template <int N>
+struct FixedKernel {
+  static_assert(N >= 3 && N % 2 == 1 && N * N <= 65536, "fixed kernels cover small odd grids");
+
+  static constexpr std::size_t capacity = DiamondGeometry::capacity(N);
+
+  // column-major position (col * N + row) of every cell along the diamond path
+  static constexpr std::array<std::uint16_t, capacity> positions = [] {
+    std::array<std::uint16_t, capacity> table{};
+    std::size_t i = 0;
+    for (int layer = 0; layer < DiamondGeometry::layers(N); ++layer) {
+      DiamondGeometry::walkLayer(N, layer, [&](const int row, const int col) {
+        table[i++] = static_cast<std::uint16_t>(col * N + row);
+      });
+    }
+    return table;
+  }();
+
+  // the walked table agrees with the closed form PermutationPlan is built from
+  static constexpr bool matchesGeometry() {
+    for (std::size_t i = 0; i < capacity; ++i) {
+      const auto [row, col] = DiamondGeometry::cellOf(N, i);
+      if (positions[i] != col * N + row) return false;
+    }
+    return true;
+  }
+  static_assert(matchesGeometry(), "walked diamond path differs from DiamondGeometry::cellOf");
+
+  // same contract as PermutationPlan::scatter, out holds N*N bytes
+  static void scatter(const char* message, const std::size_t length, char* out) {
+    if (length >= capacity) {
+      for (std::size_t i = 0; i < capacity; ++i) out[positions[i]] = message[i]; // constant trip count
+    } else {
+      for (std::size_t i = 0; i < length; ++i) out[positions[i]] = message[i];
+    }
+  }
+
+  // same contract as PermutationPlan::gather, out holds capacity bytes
+  static void gather(const char* encrypted, char* out) {
+    for (std::size_t i = 0; i < capacity; ++i) out[i] = encrypted[positions[i]];
+  }
+};
+
+class FixedKernels {
+public:
+  static constexpr int smallest = 3;
+  static constexpr int largest = 63;
+
+  static constexpr bool supports(const int size) { return size >= smallest && size <= largest && size % 2 == 1; }
+  static bool scatter(int size, const char* message, std::size_t length, char* out);
+    // runs the kernel for this grid size, false (nothing written) when there is none
+  static bool gather(int size, const char* encrypted, char* out);
+};
+
+#endif //FIXEDKERNELS_HPP
@@ -1,82 +1,83 @@
 #include "Grid.hpp"
+#include "Trace.hpp"
+#include <algorithm>
+#include <cstring>
 #include <iomanip>
-#include <thread>
-#include <chrono>
-#include <windows.h>
+#include <ostream>
 
 Grid::Grid(int size)
-    : size(size), cells(size, std::vector(size, ' ')) {} //2d vector
+    : size(size), cells(static_cast<std::size_t>(size) * size, ' ') {} // flat, one allocation for the whole grid
 
-void Grid::fillCell(const int row, const int col, const char ch) {
-  if (row >= 0 && row < size && col >= 0 && col < size) {
-    cells[row][col] = ch;
-    // display the grid after each cell is filled
-     std::cout << "Filling cell (" << row << "," << col << ") with '" << ch << "'" << std::endl;
-     display();
-     std::cout << std::endl;
-  }
+void Grid::reset(const int newSize) {
+  size = newSize;
+  cells.assign(static_cast<std::size_t>(newSize) * newSize, ' '); // only allocates when the grid grows past its capacity
 }
 
 char Grid::getCell(const int row, const int col) const {
   if (row >= 0 && row < size && col >= 0 && col < size)
-    return cells[row][col];
+    return cells[index(row, col)];
   return ' ';
 }
 
-void Grid::display() const {
+void Grid::display(std::ostream& out) const {
   // print column indices at the top
-  std::cout << "  ";
+  out << "  ";
   for (int i = 0; i < size; ++i) {
-    std::cout << std::setw(2) << i;
+    out << std::setw(2) << i;
   }
-  std::cout << std::endl;
+  out << std::endl;
 
-  std::cout << "  ";
+  out << "  ";
   for (int i = 0; i < size; ++i) {
-    std::cout << "--";
+    out << "--";
   }
-  std::cout << std::endl;
+  out << std::endl;
 
   // print rows with row indices
   for (int i = 0; i < size; ++i) {
-    std::cout << i << "| ";
+    out << i << "| ";
     for (int j = 0; j < size; ++j) {
-      std::cout << std::setw(1) << cells[i][j] << " ";
+      out << std::setw(1) << cells[index(i, j)] << " ";
     }
-    std::cout << std::endl;
+    out << std::endl;
   }
 }
 
 std::string Grid::getEncryptedMessage() const {
   std::string encrypted;
-  // read column by column
-  for (int col = 0; col < size; ++col) {
-    for (int row = 0; row < size; ++row) {
-      encrypted += cells[row][col];
+  readEncrypted(encrypted);
+  return encrypted;
+}
+
+void Grid::readEncrypted(std::string& encrypted) const {
+  DIAMOND_TRACE_SCOPE("Grid::readEncrypted"); // getEncryptedMessage and the round loops both read through here
+  if constexpr (layout == GridLayout::ColumnMajor) {
+    encrypted.assign(cells.data(), cells.size()); // already stored column by column
+  } else {
+    encrypted.clear(); // keeps the capacity
+    // read column by column
+    for (int col = 0; col < size; ++col) {
+      for (int row = 0; row < size; ++row) {
+        encrypted += cells[index(row, col)];
+      }
     }
   }
-  return encrypted;
 }
 
 // for decryption. items need to be filled in column by column
-void Grid::fillColumnByColumn(const std::string& encrypted) {
-  SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 4);
-  std::cout << "Filling grid from encrypted message:\n" << encrypted << std::endl << "\n";
-  SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 7);
-  int idx = 0;
-  for (int col = 0; col < size; ++col) {
-    for (int row = 0; row < size; ++row) {
-      if (idx < encrypted.size()) {
-        cells[row][col] = encrypted[idx++];
-      } else {
-        cells[row][col] = ' ';
+void Grid::fillColumnByColumn(const std::string_view encrypted) {
+  const std::size_t copied = std::min(encrypted.size(), cells.size());
+  if constexpr (layout == GridLayout::ColumnMajor) {
+    std::memcpy(cells.data(), encrypted.data(), copied); // the message already is the grid in column order
+    std::fill(cells.begin() + static_cast<std::ptrdiff_t>(copied), cells.end(), ' ');
+  } else {
+    std::size_t idx = 0;
+    for (int col = 0; col < size; ++col) {
+      for (int row = 0; row < size; ++row) {
+        cells[index(row, col)] = idx < copied ? encrypted[idx++] : ' ';
       }
-      // std::cout << "Filled (" << row << "," << col << ") with '"
-      //          << cells[row][col] << "'" << std::endl;
     }
   }
-  std::cout << "Final grid after reconstruction:" << std::endl;
-  this->display(); // fill grid column by column with encrypted message
   // if encrypted message is shorter than gridsize, remaining cells are empty.
 }
 
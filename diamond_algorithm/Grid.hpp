@@ -2,22 +2,59 @@
 #define GRID_HPP
 #include <vector>
 #include <string>
-#include <iostream>
+#include <string_view>
+#include <iosfwd>
+#include "AlignedAllocator.hpp"
+#include "GridObserver.hpp"
+
+// memory order of the cells, picked at compile time with DIAMOND_GRID_LAYOUT (see CMakeLists.txt)
+enum class GridLayout { RowMajor, ColumnMajor };
+
+#ifndef DIAMOND_GRID_LAYOUT
+#define DIAMOND_GRID_LAYOUT ColumnMajor // ciphertext is read column by column, so this makes it a plain copy
+#endif
 
 class Grid {
 
 public:
+  static constexpr GridLayout layout = GridLayout::DIAMOND_GRID_LAYOUT;
+
   explicit Grid(int size);
-  void display() const;
-  void fillColumnByColumn(const std::string& encrypted);
-  void fillCell(int row, int col, char ch);
+  void reset(int newSize); // blank grid of the new size, reuses the cell storage when it is big enough
+  void display(std::ostream& out) const; // the grid with row and column indices
+  void fillColumnByColumn(std::string_view encrypted);
+  template <typename Observer>
+  void fillColumnByColumn(std::string_view encrypted, const Observer& observer) {
+    fillColumnByColumn(encrypted);
+    observer.onGridLoaded(*this, encrypted);
+  }
+  void fillCell(int row, int col, char ch) { fillCell(row, col, ch, NullGridObserver{}); }
+  template <typename Observer>
+  void fillCell(const int row, const int col, const char ch, const Observer& observer) {
+    if (row >= 0 && row < size && col >= 0 && col < size) {
+      cells[index(row, col)] = ch;
+      observer.onCellFilled(*this, row, col, ch); // empty inline for NullGridObserver
+    }
+  }
 
   [[nodiscard]] std::string getEncryptedMessage() const;
+  void readEncrypted(std::string& encrypted) const; // same text into a reusable buffer
+  template <GridLayout L = layout> requires (L == GridLayout::ColumnMajor)
+  [[nodiscard]] std::string_view getEncryptedView() const { // same text as getEncryptedMessage, without the copy
+    return {cells.data(), cells.size()};
+  }
   [[nodiscard]] char getCell(int row, int col) const;
+  [[nodiscard]] char* data() { return cells.data(); } // raw cells in layout order, for bulk kernels
+  [[nodiscard]] std::size_t getCellCount() const { return cells.size(); }
   [[nodiscard]] int getSize() const;
 
 private:
   int size;
-  std::vector<std::vector<char>> cells;
+  std::vector<char, AlignedAllocator<char>> cells; // size*size cells in one contiguous block
+
+  [[nodiscard]] std::size_t index(const int row, const int col) const {
+    if constexpr (layout == GridLayout::ColumnMajor) return static_cast<std::size_t>(col) * size + row;
+    else return static_cast<std::size_t>(row) * size + col;
+  }
 };
 #endif //GRID_HPP
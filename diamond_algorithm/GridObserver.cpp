@@ -0,0 +1,19 @@
+#include "GridObserver.hpp"
+#include "Grid.hpp"
+#include <iostream>
+#include <windows.h>
+
+void ConsoleGridObserver::onCellFilled(const Grid& grid, const int row, const int col, const char ch) const {
+  // display the grid after each cell is filled
+  std::cout << "Filling cell (" << row << "," << col << ") with '" << ch << "'\n";
+  grid.display(std::cout);
+  std::cout << "\n";
+}
+
+void ConsoleGridObserver::onGridLoaded(const Grid& grid, std::string_view encrypted) const {
+  SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 4);
+  std::cout << "Filling grid from encrypted message:\n" << encrypted << "\n\n";
+  SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), 7);
+  std::cout << "Final grid after reconstruction:\n";
+  grid.display(std::cout);
+}
@@ -0,0 +1,34 @@
+/*
+ grid observers receive the cell and layer events of a Grid filled through a Cycle.
+ the observer is a compile time policy (BasicCycle<Observer>, Grid::fillCell(..., observer)):
+ NullGridObserver's hooks are empty inline functions, so quiet runs compile down to plain
+ stores. a policy derives from NullGridObserver and hides only the hooks it cares about.
+ ConsoleGridObserver is the step-by-step console animation used by the display paths.
+ */
+
+#ifndef GRIDOBSERVER_HPP
+#define GRIDOBSERVER_HPP
+#include <string> // letters passed with layer events
+#include <string_view> // ciphertext passed with grid events
+
+class Grid;
+
+struct NullGridObserver {
+  static constexpr bool watchesCells = false; // false lets a Cycle write cells in bulk, skipping onCellFilled
+  void onCellFilled(const Grid& /*grid*/, int /*row*/, int /*col*/, char /*ch*/) const {}
+    // a single cell was written
+  void onGridLoaded(const Grid& /*grid*/, std::string_view /*encrypted*/) const {}
+    // the whole grid was filled column by column from a ciphertext
+  void onLayerFilled(const Grid& /*grid*/, int /*layer*/, const std::string& /*letters*/) const {}
+    // a Cycle finished writing one diamond layer (message + random letters)
+  void onLayerExtracted(const Grid& /*grid*/, int /*layer*/, const std::string& /*letters*/) const {}
+    // a Cycle finished reading one diamond layer
+};
+
+struct ConsoleGridObserver : NullGridObserver {
+  static constexpr bool watchesCells = true;
+  void onCellFilled(const Grid& grid, int row, int col, char ch) const; // prints the cell and redraws the grid
+  void onGridLoaded(const Grid& grid, std::string_view encrypted) const; // prints the ciphertext and the rebuilt grid
+};
+
+#endif //GRIDOBSERVER_HPP
@@ -0,0 +1,60 @@
+#include "GridView.hpp"
+#include "DiamondGeometry.hpp"
+
+namespace {
+  // reads the diamond of an odd grid in path order into out, skipping blank cells, and returns the
+  // letters written. Stop ends the walk right after the first terminator
+  template <bool Stop>
+  std::size_t readDiamond(const char* cells, const int size, char* out, const char terminator) {
+    std::size_t written = 0;
+    for (int layer = 0; layer < DiamondGeometry::layers(size); ++layer) {
+      for (const auto& run : DiamondGeometry::layerRuns(size, layer)) {
+        // column-major, so a (rowStep, colStep) step is a fixed jump through the ciphertext
+        const std::ptrdiff_t stride = static_cast<std::ptrdiff_t>(run.colStep) * size + run.rowStep;
+        const char* in = cells + static_cast<std::ptrdiff_t>(run.start.col) * size + run.start.row;
+        for (int k = 0; k < run.length; ++k, in += stride) {
+          out[written] = *in;
+          written += *in != ' '; // a blank cell is overwritten by the next letter, no second pass
+          if constexpr (Stop) {
+            if (*in == terminator) return written;
+          }
+        }
+      }
+    }
+    return written;
+  }
+}
+
+GridView::GridView(const std::string_view encrypted)
+    : cells(encrypted), size(DiamondGeometry::gridSizeOfCipher(encrypted.size())) {}
+
+char GridView::getCell(const int row, const int col) const {
+  if (row >= 0 && row < size && col >= 0 && col < size)
+    return cells[static_cast<std::size_t>(col) * size + row];
+  return ' ';
+}
+
+void GridView::extractDiamond(std::string& message) const {
+  if (size % 2 == 0) {
+    // even grids have no closed form, walk the cells like Cycle does
+    message.clear();
+    for (int layer = 0; layer < DiamondGeometry::layers(size); ++layer) {
+      DiamondGeometry::walkLayer(size, layer, [&](const int row, const int col) {
+        if (const char c = getCell(row, col); c != ' ') message += c;
+      });
+    }
+    return;
+  }
+  message.resize(DiamondGeometry::capacity(size));
+  message.resize(readDiamond<false>(cells.data(), size, message.data(), '\0'));
+}
+
+void GridView::extractUntil(std::string& message, const char terminator) const {
+  if (size % 2 == 0) {
+    extractDiamond(message); // rare, read it all and cut
+    if (const std::size_t end = message.find(terminator); end != std::string::npos) message.resize(end + 1);
+    return;
+  }
+  message.resize(DiamondGeometry::capacity(size));
+  message.resize(readDiamond<true>(cells.data(), size, message.data(), terminator));
+}
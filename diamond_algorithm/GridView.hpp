@@ -0,0 +1,35 @@
+/*
+ GridView reads a ciphertext as the column-major grid it came from, without copying it into a Grid.
+ cell (row, col) is encrypted[col * size + row], so every diagonal run of a diamond layer is a
+ constant stride through the ciphertext (size - 1 or size + 1) and the diamond can be read straight
+ out of the input: one read of the ciphertext, one write of the message.
+ */
+
+#ifndef GRIDVIEW_HPP
+#define GRIDVIEW_HPP
+#include <cstddef> // strides
+#include <string> // extracted message
+#include <string_view> // the viewed ciphertext
+
+class GridView {
+public:
+  explicit GridView(std::string_view encrypted);
+    // size is floor(sqrt(length)) like Decryptor, characters past size*size are ignored.
+    // the view does not own the text, it has to outlive the view
+
+  [[nodiscard]] int getSize() const { return size; }
+  [[nodiscard]] char getCell(int row, int col) const; // ' ' outside the grid, same as Grid::getCell
+
+  void extractDiamond(std::string& message) const;
+    // every layer in path order into message (replacing its contents, keeping its capacity),
+    // blank cells skipped. same text as Cycle::extractToMessage over all layers of a Grid
+    // loaded with fillColumnByColumn
+  void extractUntil(std::string& message, char terminator) const;
+    // same, but stops after the first terminator: the cells past it are never read
+
+private:
+  std::string_view cells;
+  int size;
+};
+
+#endif //GRIDVIEW_HPP
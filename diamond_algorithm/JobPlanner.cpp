@@ -0,0 +1,57 @@
+#include "JobPlanner.hpp"
+#include "DiamondGeometry.hpp"
+#include <algorithm>
+
+namespace {
+  // past this a grid side no longer fits an int and size * size no longer fits 64 bits
+  constexpr std::uint64_t largestLength = std::uint64_t{1} << 60;
+}
+
+JobPlan JobPlanner::forEncryption(const std::uint64_t length, const int rounds, const int gridSize) {
+  JobPlan plan;
+  plan.inputLength = length;
+  plan.rounds.reserve(std::max(rounds, 0));
+  std::uint64_t current = length;
+  double cells = 0;
+  for (int round = 0; round < rounds; ++round) {
+    if (current > largestLength) {
+      plan.overflow = true;
+      break;
+    }
+    const int size = gridSize > 0 ? gridSize : DiamondGeometry::gridSizeFor(current);
+    const std::uint64_t output = static_cast<std::uint64_t>(size) * size;
+    plan.rounds.push_back({size, current, output});
+    plan.largestOutput = std::max(plan.largestOutput, output);
+    // the round's input, the grid and the string read out of it
+    plan.peakMemory = std::max(plan.peakMemory, length + current + 2 * output);
+    cells += static_cast<double>(output);
+    current = output;
+  }
+  plan.outputLength = current;
+  // the single pass engine keeps a 4 byte table entry per message character next to the output
+  plan.peakMemory = std::max(plan.peakMemory, 5 * length + current);
+  plan.estimatedSeconds = cells / encryptCellsPerSecond;
+  return plan;
+}
+
+JobPlan JobPlanner::forDecryption(const std::uint64_t length, const int rounds) {
+  JobPlan plan;
+  plan.inputLength = length;
+  plan.rounds.reserve(std::max(rounds, 0));
+  std::uint64_t current = length;
+  double cells = 0;
+  for (int round = 0; round < rounds; ++round) {
+    const int size = DiamondGeometry::gridSizeOfCipher(current);
+    std::uint64_t output = DiamondGeometry::capacity(size);
+    if (round < rounds - 1) output = DiamondGeometry::oddSquareTrim(output);
+    plan.rounds.push_back({size, current, output});
+    plan.largestOutput = std::max(plan.largestOutput, output);
+    plan.peakMemory = std::max(plan.peakMemory, length + current + static_cast<std::uint64_t>(size) * size + output);
+    cells += static_cast<double>(size) * size;
+    current = output;
+  }
+  plan.outputLength = current;
+  plan.peakMemory = std::max(plan.peakMemory, length + 5 * current);
+  plan.estimatedSeconds = cells / decryptCellsPerSecond;
+  return plan;
+}
@@ -0,0 +1,45 @@
+/*
+ JobPlanner works out what a multi-round job will cost before any of it runs.
+ every round writes a full size x size grid, so the length roughly doubles per round
+ and a few extra rounds can turn a short message into gigabytes.
+ the plan lists each round's grid and output length, the peak memory of the
+ round by round engine and a runtime estimate, all from DiamondGeometry in O(rounds).
+ */
+
+#ifndef JOBPLANNER_HPP
+#define JOBPLANNER_HPP
+#include <cstdint>
+#include <vector>
+
+struct RoundPlan {
+  int gridSize;
+  std::uint64_t inputLength; // characters going into the round
+  std::uint64_t outputLength; // characters coming out (size * size when encrypting)
+};
+
+struct JobPlan {
+  std::vector<RoundPlan> rounds; // in processing order
+  std::uint64_t inputLength = 0;
+  std::uint64_t outputLength = 0;
+  std::uint64_t largestOutput = 0; // longest round output, what a reused round buffer has to hold
+  std::uint64_t peakMemory = 0; // bytes, estimate of the largest set of buffers alive at once
+  double estimatedSeconds = 0;
+  bool overflow = false; // lengths outgrow 64 bits / int grid sizes, the job can't run at all
+
+  [[nodiscard]] bool fits(const std::uint64_t budget) const { return !overflow && peakMemory <= budget; }
+};
+
+class JobPlanner {
+public:
+  // throughput used for estimatedSeconds, in grid cells per second.
+  // single round speeds of diamond_bench on a desktop, rounded down
+  static constexpr double encryptCellsPerSecond = 100e6;
+  static constexpr double decryptCellsPerSecond = 400e6;
+
+  static JobPlan forEncryption(std::uint64_t length, int rounds, int gridSize = 0);
+    // length is the prepared message length (Encryptor::preparedLength), gridSize <= 0 = automatic grids
+  static JobPlan forDecryption(std::uint64_t length, int rounds);
+    // length is the ciphertext length
+};
+
+#endif //JOBPLANNER_HPP
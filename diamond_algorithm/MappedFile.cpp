@@ -0,0 +1,171 @@
+#include "MappedFile.hpp"
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile MappedFile::openRead(const std::string& path, const Access access) {
+  MappedFile mapped;
+  // Windows takes the access pattern as a hint when the file is opened
+  const DWORD hint = access == Access::Sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS;
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, hint, nullptr);
+  if (file == INVALID_HANDLE_VALUE) throw std::runtime_error("cannot open " + path);
+  mapped.file = file;
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size)) throw std::runtime_error("cannot read the size of " + path);
+  mapped.length = static_cast<std::size_t>(size.QuadPart);
+  if (mapped.length == 0) return mapped; // empty files can't be mapped
+
+  mapped.mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!mapped.mapping) throw std::runtime_error("cannot map " + path);
+  mapped.view = static_cast<char*>(MapViewOfFile(mapped.mapping, FILE_MAP_READ, 0, 0, 0));
+  if (!mapped.view) throw std::runtime_error("cannot map " + path);
+  return mapped;
+}
+
+MappedFile MappedFile::create(const std::string& path, const std::size_t size, const Access access) {
+  MappedFile mapped;
+  const DWORD hint = access == Access::Sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS;
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, hint, nullptr);
+  if (file == INVALID_HANDLE_VALUE) throw std::runtime_error("cannot create " + path);
+  mapped.file = file;
+  mapped.writable = true;
+  mapped.length = size;
+  if (size == 0) return mapped;
+
+  const auto wide = static_cast<unsigned long long>(size);
+  mapped.mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE,
+                                      static_cast<DWORD>(wide >> 32), static_cast<DWORD>(wide & 0xFFFFFFFFu), nullptr);
+  if (!mapped.mapping) throw std::runtime_error("cannot size " + path);
+  mapped.view = static_cast<char*>(MapViewOfFile(mapped.mapping, FILE_MAP_WRITE, 0, 0, 0));
+  if (!mapped.view) throw std::runtime_error("cannot map " + path);
+  return mapped;
+}
+
+void MappedFile::truncate(const std::size_t newSize) {
+  if (view) UnmapViewOfFile(view);
+  if (mapping) CloseHandle(mapping);
+  view = nullptr;
+  mapping = nullptr;
+  LARGE_INTEGER position;
+  position.QuadPart = static_cast<LONGLONG>(newSize);
+  if (!SetFilePointerEx(file, position, nullptr, FILE_BEGIN) || !SetEndOfFile(file)) {
+    throw std::runtime_error("cannot resize output file");
+  }
+  length = newSize;
+}
+
+void MappedFile::close() {
+  if (view) {
+    if (writable) FlushViewOfFile(view, 0);
+    UnmapViewOfFile(view);
+  }
+  if (mapping) CloseHandle(mapping);
+  if (file) CloseHandle(file);
+  view = nullptr;
+  mapping = nullptr;
+  file = nullptr;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : view(std::exchange(other.view, nullptr)), length(std::exchange(other.length, 0)),
+      writable(other.writable), file(std::exchange(other.file, nullptr)),
+      mapping(std::exchange(other.mapping, nullptr)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+  if (this != &other) {
+    close();
+    view = std::exchange(other.view, nullptr);
+    length = std::exchange(other.length, 0);
+    writable = other.writable;
+    file = std::exchange(other.file, nullptr);
+    mapping = std::exchange(other.mapping, nullptr);
+  }
+  return *this;
+}
+
+#else
+
+namespace {
+  void advise(char* view, const std::size_t length, const MappedFile::Access access) {
+    madvise(view, length, access == MappedFile::Access::Sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+  }
+}
+
+MappedFile MappedFile::openRead(const std::string& path, const Access access) {
+  MappedFile mapped;
+  mapped.descriptor = ::open(path.c_str(), O_RDONLY);
+  if (mapped.descriptor < 0) throw std::runtime_error("cannot open " + path);
+
+  struct stat info{};
+  if (fstat(mapped.descriptor, &info) != 0) throw std::runtime_error("cannot read the size of " + path);
+  mapped.length = static_cast<std::size_t>(info.st_size);
+  if (mapped.length == 0) return mapped; // empty files can't be mapped
+
+  void* view = mmap(nullptr, mapped.length, PROT_READ, MAP_PRIVATE, mapped.descriptor, 0);
+  if (view == MAP_FAILED) throw std::runtime_error("cannot map " + path);
+  mapped.view = static_cast<char*>(view);
+  advise(mapped.view, mapped.length, access);
+  return mapped;
+}
+
+MappedFile MappedFile::create(const std::string& path, const std::size_t size, const Access access) {
+  MappedFile mapped;
+  mapped.descriptor = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (mapped.descriptor < 0) throw std::runtime_error("cannot create " + path);
+  mapped.writable = true;
+  mapped.length = size;
+  if (size == 0) return mapped;
+
+  if (ftruncate(mapped.descriptor, static_cast<off_t>(size)) != 0) throw std::runtime_error("cannot size " + path);
+  void* view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, mapped.descriptor, 0);
+  if (view == MAP_FAILED) throw std::runtime_error("cannot map " + path);
+  mapped.view = static_cast<char*>(view);
+  advise(mapped.view, size, access);
+  return mapped;
+}
+
+void MappedFile::truncate(const std::size_t newSize) {
+  if (view) munmap(view, length);
+  view = nullptr;
+  if (ftruncate(descriptor, static_cast<off_t>(newSize)) != 0) throw std::runtime_error("cannot resize output file");
+  length = newSize;
+}
+
+void MappedFile::close() {
+  if (view) munmap(view, length); // MAP_SHARED pages reach the file without an explicit sync
+  if (descriptor >= 0) ::close(descriptor);
+  view = nullptr;
+  descriptor = -1;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : view(std::exchange(other.view, nullptr)), length(std::exchange(other.length, 0)),
+      writable(other.writable), descriptor(std::exchange(other.descriptor, -1)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+  if (this != &other) {
+    close();
+    view = std::exchange(other.view, nullptr);
+    length = std::exchange(other.length, 0);
+    writable = other.writable;
+    descriptor = std::exchange(other.descriptor, -1);
+  }
+  return *this;
+}
+
+#endif
+
+MappedFile::~MappedFile() {
+  close();
+}
@@ -0,0 +1,49 @@
+/*
+ MappedFile maps a whole file into memory (CreateFileMapping on Windows, mmap elsewhere).
+ input files are mapped read-only, output files are created at their final size and
+ written in place. the access hint tells the OS how the pages will be touched.
+ errors are reported with std::runtime_error.
+ */
+
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+#include <cstddef> // size_t
+#include <string> // file paths
+
+class MappedFile {
+public:
+  enum class Access { Sequential, Random };
+
+  static MappedFile openRead(const std::string& path, Access access);
+  static MappedFile create(const std::string& path, std::size_t size, Access access);
+    // creates (or replaces) path with size bytes, mapped for writing
+
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  ~MappedFile();
+
+  [[nodiscard]] char* data() { return view; }
+  [[nodiscard]] const char* data() const { return view; }
+  [[nodiscard]] std::size_t size() const { return length; }
+
+  void truncate(std::size_t newSize);
+    // unmaps the file and cuts it to newSize bytes (output files only), the mapping is gone afterwards
+
+private:
+  MappedFile() = default;
+  void close();
+
+  char* view = nullptr;
+  std::size_t length = 0;
+  bool writable = false;
+#ifdef _WIN32
+  void* file = nullptr; // HANDLE, kept as void* so windows.h stays out of this header
+  void* mapping = nullptr;
+#else
+  int descriptor = -1;
+#endif
+};
+
+#endif //MAPPEDFILE_HPP
@@ -0,0 +1,56 @@
+#include "PaddingGenerator.hpp"
+#include "PaddingKernel.hpp"
+#include <algorithm>
+#include <random>
+
+namespace {
+  std::uint64_t splitmix64(std::uint64_t& x) {
+    std::uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+  }
+
+  std::uint64_t rotl(const std::uint64_t x, const int k) {
+    return (x << k) | (x >> (64 - k));
+  }
+}
+
+void PaddingGenerator::fillBits(std::uint64_t* out, const std::size_t count) {
+  for (std::size_t i = 0; i < count; ++i) out[i] = next();
+}
+
+void PaddingGenerator::fillLetters(char* out, const std::size_t count) {
+  constexpr std::size_t chunkWords = 64;
+  std::uint64_t words[chunkWords];
+  std::size_t done = 0;
+  while (done < count) {
+    const std::size_t letters = std::min(count - done, chunkWords * 4);
+    fillBits(words, (letters + 3) / 4);
+    lettersFromBits(words, out + done, letters); // vectorised multiply-shift
+    done += letters;
+  }
+}
+
+XoshiroPadding::XoshiroPadding()
+    : XoshiroPadding((static_cast<std::uint64_t>(std::random_device{}()) << 32) ^ std::random_device{}()) {}
+
+XoshiroPadding::XoshiroPadding(std::uint64_t seed) {
+  for (auto& word : state) word = splitmix64(seed); // never all zero
+}
+
+std::uint64_t XoshiroPadding::next() {
+  const std::uint64_t result = rotl(state[1] * 5, 7) * 9;
+  const std::uint64_t t = state[1] << 17;
+  state[2] ^= state[0];
+  state[3] ^= state[1];
+  state[1] ^= state[2];
+  state[0] ^= state[3];
+  state[2] ^= t;
+  state[3] = rotl(state[3], 45);
+  return result;
+}
+
+void XoshiroPadding::fillBits(std::uint64_t* out, const std::size_t count) {
+  for (std::size_t i = 0; i < count; ++i) out[i] = next(); // non-virtual here, so the loop inlines
+}
@@ -0,0 +1,32 @@
+/*
+ PaddingGenerator produces the random letters that hide the message in the grid.
+ generators are seeded once and hand out letters in bulk. XoshiroPadding is the
+ default (xoshiro256**, seeded through splitmix64); give it a fixed seed to get
+ reproducible ciphertexts for regression tests and benchmarks.
+ */
+
+#ifndef PADDINGGENERATOR_HPP
+#define PADDINGGENERATOR_HPP
+#include <cstddef> // size_t
+#include <cstdint> // 64 bit state
+
+class PaddingGenerator {
+public:
+  virtual ~PaddingGenerator() = default;
+  virtual std::uint64_t next() = 0; // 64 fresh random bits
+  virtual void fillBits(std::uint64_t* out, std::size_t count); // count words of random bits
+  void fillLetters(char* out, std::size_t count);
+    // writes count random letters 'A'..'Z' into out, four letters per 64 bit word
+};
+
+class XoshiroPadding final : public PaddingGenerator {
+public:
+  XoshiroPadding(); // seeded once from std::random_device
+  explicit XoshiroPadding(std::uint64_t seed); // deterministic stream for this seed
+  std::uint64_t next() override;
+  void fillBits(std::uint64_t* out, std::size_t count) override;
+private:
+  std::uint64_t state[4];
+};
+
+#endif //PADDINGGENERATOR_HPP
@@ -0,0 +1,70 @@
+#include "PaddingKernel.hpp"
+#include "PaddingGenerator.hpp"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+void lettersFromBits(const std::uint64_t* bits, char* out, const std::size_t count) {
+  const auto* lanes = reinterpret_cast<const unsigned char*>(bits);
+  std::size_t i = 0;
+#if defined(__AVX2__)
+  const __m256i scale = _mm256_set1_epi16(26);
+  const __m256i base = _mm256_set1_epi8('A');
+  for (; i + 32 <= count; i += 32) {
+    const __m256i lo = _mm256_mulhi_epu16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanes + 2 * i)), scale);
+    const __m256i hi = _mm256_mulhi_epu16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanes + 2 * i + 32)), scale);
+    // packus works per 128 bit half, the permute puts the four quarters back in order
+    const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), 0xD8);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_add_epi8(packed, base));
+  }
+#elif defined(__SSE2__) || defined(_M_X64)
+  const __m128i scale = _mm_set1_epi16(26);
+  const __m128i base = _mm_set1_epi8('A');
+  for (; i + 16 <= count; i += 16) {
+    const __m128i lo = _mm_mulhi_epu16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes + 2 * i)), scale);
+    const __m128i hi = _mm_mulhi_epu16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes + 2 * i + 16)), scale);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_add_epi8(_mm_packus_epi16(lo, hi), base));
+  }
+#endif
+  for (; i < count; ++i) {
+    const std::uint64_t lane = (bits[i / 4] >> (16 * (i % 4))) & 0xFFFF;
+    out[i] = static_cast<char>('A' + ((lane * 26) >> 16));
+  }
+}
+
+void padBlankCells(char* cells, const std::size_t count, PaddingGenerator& padding) {
+  constexpr std::size_t chunk = 256;
+  char letters[chunk];
+  for (std::size_t start = 0; start < count; start += chunk) {
+    char* block = cells + start;
+    const std::size_t length = std::min(chunk, count - start);
+    if (!std::memchr(block, ' ', length)) continue; // fully occupied, no letters needed
+    padding.fillLetters(letters, length);
+
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    const __m256i blank = _mm256_set1_epi8(' ');
+    for (; i + 32 <= length; i += 32) {
+      const __m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + i));
+      const __m256i random = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(letters + i));
+      const __m256i empty = _mm256_cmpeq_epi8(current, blank); // occupancy mask for these 32 cells
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(block + i), _mm256_blendv_epi8(current, random, empty));
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    const __m128i blank = _mm_set1_epi8(' ');
+    for (; i + 16 <= length; i += 16) {
+      const __m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+      const __m128i random = _mm_loadu_si128(reinterpret_cast<const __m128i*>(letters + i));
+      const __m128i empty = _mm_cmpeq_epi8(current, blank);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(block + i),
+                       _mm_or_si128(_mm_and_si128(empty, random), _mm_andnot_si128(empty, current)));
+    }
+#endif
+    for (; i < length; ++i) {
+      if (block[i] == ' ') block[i] = letters[i];
+    }
+  }
+}
@@ -0,0 +1,20 @@
+/*
+ PaddingKernel turns raw random bits into padding letters and blends them into a grid.
+ every 16 bits become one letter 'A'..'Z' through a multiply-shift ((bits * 26) >> 16),
+ done 32 letters at a time with AVX2 (16 with SSE2) and a scalar loop for the tail.
+ all code paths give the same letters for the same bits.
+ */
+
+#ifndef PADDINGKERNEL_HPP
+#define PADDINGKERNEL_HPP
+#include <cstddef> // size_t
+#include <cstdint> // random words
+
+class PaddingGenerator;
+
+void lettersFromBits(const std::uint64_t* bits, char* out, std::size_t count);
+  // writes count letters, letter i uses bits 16*(i%4) .. 16*(i%4)+15 of bits[i/4]
+void padBlankCells(char* cells, std::size_t count, PaddingGenerator& padding);
+  // replaces every ' ' in cells with a random letter, occupied cells are left untouched
+
+#endif //PADDINGKERNEL_HPP
@@ -0,0 +1,74 @@
+#include "PermutationPlan.hpp"
+#include "DiamondGeometry.hpp"
+#include "PlanCache.hpp"
+#include <limits>
+#include <stdexcept>
+
+namespace {
+  PlanCache<int, PermutationPlan>& planCache() {
+    static PlanCache<int, PermutationPlan> cache(64u << 20); // 64 MB of index tables by default
+    return cache;
+  }
+}
+
+PermutationPlan::PermutationPlan(const int size)
+    : size{size} {
+  if (size <= 0 || size % 2 == 0) {
+    throw std::invalid_argument("PermutationPlan needs an odd grid size");
+  }
+  if (getCellCount() > std::numeric_limits<std::uint32_t>::max()) {
+    throw std::length_error("grid too large for 32 bit plan indices");
+  }
+  capacity = DiamondGeometry::capacity(size);
+  const bool compact = getCellCount() <= std::numeric_limits<std::uint16_t>::max() + std::size_t{1};
+  if (compact) narrow.resize(capacity);
+  else wide.resize(capacity);
+
+  for (std::size_t i = 0; i < capacity; ++i) {
+    const auto [row, col] = DiamondGeometry::cellOf(size, i);
+    const auto position = static_cast<std::uint32_t>(static_cast<std::size_t>(col) * size + row); // column-major, same order as Grid::getEncryptedMessage
+    if (compact) narrow[i] = static_cast<std::uint16_t>(position);
+    else wide[i] = position;
+  }
+}
+
+std::shared_ptr<const PermutationPlan> PermutationPlan::forSize(const int size) {
+  return planCache().get(size, [size] { return std::make_shared<const PermutationPlan>(size); });
+}
+
+void PermutationPlan::setCacheBudget(const std::size_t bytes) {
+  planCache().setBudget(bytes);
+}
+
+void PermutationPlan::scatter(const char* message, std::size_t length, char* out) const {
+  if (length > capacity) length = capacity;
+  if (wide.empty()) {
+    for (std::size_t i = 0; i < length; ++i) out[narrow[i]] = message[i];
+  } else {
+    for (std::size_t i = 0; i < length; ++i) out[wide[i]] = message[i];
+  }
+}
+
+void PermutationPlan::gather(const char* encrypted, char* out) const {
+  if (wide.empty()) {
+    for (std::size_t i = 0; i < capacity; ++i) out[i] = encrypted[narrow[i]];
+  } else {
+    for (std::size_t i = 0; i < capacity; ++i) out[i] = encrypted[wide[i]];
+  }
+}
+
+std::size_t PermutationPlan::getMemoryUsage() const {
+  return sizeof(PermutationPlan)
+       + narrow.capacity() * sizeof(std::uint16_t)
+       + wide.capacity() * sizeof(std::uint32_t);
+}
+
+std::vector<std::pair<int, int>> PermutationPlan::getLayerPath(const int layer) const {
+  std::vector<std::pair<int, int>> path;
+  const std::size_t start = DiamondGeometry::layerOffset(size, layer);
+  for (std::size_t i = start; i < start + DiamondGeometry::layerLength(size, layer); ++i) {
+    const auto position = static_cast<int>((*this)[i]);
+    path.emplace_back(position % size, position / size);
+  }
+  return path;
+}
@@ -0,0 +1,44 @@
+/*
+ PermutationPlan stores the diamond path of one grid size as a flat index table.
+ entry i is the column-major position (col * size + row) of the i-th cell along the
+ diamond path, so encryption is a single scatter and decryption a single gather.
+ plans are built once per grid size and shared through a small bounded cache.
+ */
+
+#ifndef PERMUTATIONPLAN_HPP
+#define PERMUTATIONPLAN_HPP
+#include <cstddef> // size_t
+#include <cstdint> // compact 16/32 bit indices
+#include <memory> // shared plans handed out by the cache
+#include <utility> // using pairs (row, col)
+#include <vector> // index tables
+
+class PermutationPlan {
+public:
+  explicit PermutationPlan(int size); // builds the table for an odd grid size
+  static std::shared_ptr<const PermutationPlan> forSize(int size);
+    // returns the cached plan for this size, building it on first use
+  static void setCacheBudget(std::size_t bytes);
+    // caps the memory held by cached plans, least recently used plans are dropped first
+
+  void scatter(const char* message, std::size_t length, char* out) const;
+    // places message[i] at its grid position in out (size*size bytes, column-major)
+    // only the first getCapacity() characters fit on the diamond, the rest are dropped
+  void gather(const char* encrypted, char* out) const;
+    // reads the diamond cells of a column-major grid into out (getCapacity() bytes)
+
+  [[nodiscard]] std::size_t operator[](std::size_t i) const { return wide.empty() ? narrow[i] : wide[i]; }
+  [[nodiscard]] int getSize() const { return size; }
+  [[nodiscard]] std::size_t getCapacity() const { return capacity; } // cells on the diamond path
+  [[nodiscard]] std::size_t getCellCount() const { return static_cast<std::size_t>(size) * size; }
+  [[nodiscard]] std::size_t getMemoryUsage() const;
+  [[nodiscard]] std::vector<std::pair<int, int>> getLayerPath(int layer) const;
+    // (row, col) pairs of one layer, only used for displaying the path
+private:
+  int size;
+  std::size_t capacity = 0;
+  std::vector<std::uint16_t> narrow; // used while size*size fits 16 bits
+  std::vector<std::uint32_t> wide; // used for bigger grids
+};
+
+#endif //PERMUTATIONPLAN_HPP
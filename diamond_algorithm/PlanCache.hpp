@@ -0,0 +1,70 @@
+/*
+ PlanCache is a small thread safe least-recently-used cache for precomputed plans.
+ the memory budget is counted with Plan::getMemoryUsage(), the newest plan is always kept.
+ */
+
+#ifndef PLANCACHE_HPP
+#define PLANCACHE_HPP
+#include <cstddef> // size_t
+#include <functional> // std::hash
+#include <list> // recency order
+#include <memory> // shared plans
+#include <mutex> // plans are shared between threads
+#include <unordered_map> // lookup by key
+
+template <typename Key, typename Plan, typename Hash = std::hash<Key>>
+class PlanCache {
+public:
+  explicit PlanCache(const std::size_t budget) : budget{budget} {}
+
+  // returns the cached plan for key, or builds it with build() and caches it
+  // build() may return nullptr, which is passed through and not cached
+  template <typename Build>
+  std::shared_ptr<const Plan> get(const Key& key, Build build) {
+    {
+      std::lock_guard lock(mutex);
+      if (const auto found = byKey.find(key); found != byKey.end()) {
+        order.splice(order.begin(), order, found->second); // mark as recently used
+        return found->second->second;
+      }
+    }
+
+    std::shared_ptr<const Plan> plan = build(); // build outside the lock
+    if (!plan) return plan; // nothing to cache when the plan can't be built
+
+    std::lock_guard lock(mutex);
+    if (const auto found = byKey.find(key); found != byKey.end()) {
+      return found->second->second; // another thread built it first
+    }
+    order.emplace_front(key, plan);
+    byKey[key] = order.begin();
+    used += plan->getMemoryUsage();
+    evict();
+    return plan;
+  }
+
+  void setBudget(const std::size_t bytes) {
+    std::lock_guard lock(mutex);
+    budget = bytes;
+    evict();
+  }
+
+private:
+  using Entry = std::pair<Key, std::shared_ptr<const Plan>>;
+
+  void evict() {
+    while (used > budget && order.size() > 1) {
+      used -= order.back().second->getMemoryUsage();
+      byKey.erase(order.back().first);
+      order.pop_back();
+    }
+  }
+
+  std::mutex mutex;
+  std::size_t budget;
+  std::size_t used = 0;
+  std::list<Entry> order; // front = most recently used
+  std::unordered_map<Key, typename std::list<Entry>::iterator, Hash> byKey;
+};
+
+#endif //PLANCACHE_HPP
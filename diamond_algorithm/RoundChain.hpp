@@ -0,0 +1,85 @@
+/*
+ RoundChain lists the grid of every round, worked out from the message length alone,
+ and maps single positions through all rounds with DiamondGeometry, no tables.
+ it is the O(1)-memory counterpart of ComposedPlan, for huge inputs and random access.
+ */
+
+#ifndef ROUNDCHAIN_HPP
+#define ROUNDCHAIN_HPP
+#include "DiamondGeometry.hpp"
+#include <cstdint> // 64 bit positions
+#include <vector> // grid size per round
+
+class RoundChain {
+public:
+  static constexpr std::uint64_t dropped = UINT64_MAX; // message character that never reaches the ciphertext
+
+  // rounds of Encryptor: grid from the current length (or the fixed gridSize), output is the whole grid
+  static RoundChain forEncryption(std::uint64_t length, const int rounds, const int gridSize = 0) {
+    RoundChain chain;
+    chain.inputLength = length;
+    for (int round = 0; round < rounds; ++round) {
+      const int size = gridSize > 0 ? gridSize : DiamondGeometry::gridSizeFor(length);
+      chain.valid = chain.valid && size % 2 == 1;
+      chain.gridSizes.push_back(size);
+      length = static_cast<std::uint64_t>(size) * size;
+    }
+    chain.outputLength = length;
+    return chain;
+  }
+
+  // rounds of Decryptor: grid from sqrt, diamond read out, trimmed to the largest odd square between rounds
+  static RoundChain forDecryption(std::uint64_t length, const int rounds) {
+    RoundChain chain;
+    chain.inputLength = length;
+    for (int round = 0; round < rounds; ++round) {
+      const int size = DiamondGeometry::gridSizeOfCipher(length);
+      chain.valid = chain.valid && size % 2 == 1;
+      chain.gridSizes.push_back(size);
+      length = DiamondGeometry::capacity(size);
+      if (round < rounds - 1) length = DiamondGeometry::oddSquareTrim(length);
+    }
+    chain.outputLength = length;
+    return chain;
+  }
+
+  [[nodiscard]] bool isValid() const { return valid; } // false when a round grid has even size (no closed form)
+  [[nodiscard]] std::uint64_t getInputLength() const { return inputLength; }
+  [[nodiscard]] std::uint64_t getOutputLength() const { return outputLength; }
+  [[nodiscard]] const std::vector<int>& getGridSizes() const { return gridSizes; }
+
+  // encryption: where message character index ends up in the ciphertext, or dropped
+  [[nodiscard]] std::uint64_t encryptedPosition(std::uint64_t index) const {
+    for (const int size : gridSizes) {
+      if (index >= DiamondGeometry::capacity(size)) return dropped; // overflowed a fixed grid
+      const auto [row, col] = DiamondGeometry::cellOf(size, index);
+      index = static_cast<std::uint64_t>(col) * size + row; // column-major read out
+    }
+    return index;
+  }
+
+  // decryption: which ciphertext position plaintext character index comes from
+  [[nodiscard]] std::uint64_t sourcePosition(std::uint64_t index) const {
+    for (auto size = gridSizes.rbegin(); size != gridSizes.rend(); ++size) {
+      const auto [row, col] = DiamondGeometry::cellOf(*size, index);
+      index = static_cast<std::uint64_t>(col) * *size + row;
+    }
+    return index;
+  }
+
+  // encryption: out[encryptedPosition(i)] = message[i] for the inputLength message characters, like ComposedPlan::scatter
+  void scatter(const char* message, char* out) const {
+    for (std::uint64_t i = 0; i < inputLength; ++i) {
+      if (const std::uint64_t position = encryptedPosition(i); position != dropped) out[position] = message[i];
+    }
+  }
+
+private:
+  RoundChain() = default;
+  bool valid = true;
+  std::uint64_t inputLength = 0;
+  std::uint64_t outputLength = 0;
+  std::vector<int> gridSizes;
+};
+
+#endif //ROUNDCHAIN_HPP
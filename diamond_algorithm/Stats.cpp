@@ -0,0 +1,138 @@
+#include "Stats.hpp"
+#include <cstdlib>
+#include <new>
+
+#ifdef DIAMOND_COUNT_ALLOCATIONS
+// counting replacements of the global allocation functions, only in builds that ask for them (see CMakeLists.txt)
+namespace {
+  thread_local std::uint64_t allocationCount = 0;
+
+  void* countedAllocation(const std::size_t size, const std::size_t alignment) {
+    ++allocationCount;
+    void* pointer = nullptr;
+#ifdef _WIN32
+    pointer = _aligned_malloc(size ? size : 1, alignment);
+#else
+    if (posix_memalign(&pointer, alignment < sizeof(void*) ? sizeof(void*) : alignment, size ? size : 1) != 0) pointer = nullptr;
+#endif
+    if (!pointer) throw std::bad_alloc();
+    return pointer;
+  }
+
+  void countedFree(void* pointer) noexcept {
+#ifdef _WIN32
+    _aligned_free(pointer);
+#else
+    std::free(pointer);
+#endif
+  }
+}
+
+void* operator new(const std::size_t size) { return countedAllocation(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new(const std::size_t size, const std::align_val_t alignment) {
+  return countedAllocation(size, static_cast<std::size_t>(alignment));
+}
+void operator delete(void* pointer) noexcept { countedFree(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { countedFree(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { countedFree(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { countedFree(pointer); }
+#endif
+
+const char* Stats::phaseName(const Phase phase) {
+  switch (phase) {
+    case Phase::Prepare: return "prepare";
+    case Phase::PathBuild: return "pathBuild";
+    case Phase::Fill: return "fill";
+    case Phase::Pad: return "pad";
+    case Phase::Serialize: return "serialize";
+    case Phase::Ingest: return "ingest";
+    case Phase::Extract: return "extract";
+    case Phase::Trim: return "trim";
+  }
+  return "";
+}
+
+void Stats::clear() {
+  rounds.clear(); // keeps the capacity for the next call
+  seconds = {};
+  totalSeconds = 0;
+  composed = false;
+  bytesIn = bytesOut = allocations = 0;
+}
+
+std::vector<int> Stats::gridSizes() const {
+  std::vector<int> sizes;
+  sizes.reserve(rounds.size());
+  for (const auto& round : rounds) sizes.push_back(round.gridSize);
+  return sizes;
+}
+
+void Stats::beginRound(const int gridSize, const std::uint64_t inputLength) {
+  rounds.push_back({gridSize, inputLength, 0, {}});
+}
+
+void Stats::endRound(const std::uint64_t outputLength) {
+  if (!rounds.empty()) rounds.back().outputLength = outputLength;
+}
+
+void Stats::add(const Phase phase, const double elapsed) {
+  seconds[static_cast<int>(phase)] += elapsed;
+  if (!rounds.empty() && !composed) rounds.back().seconds[static_cast<int>(phase)] += elapsed;
+}
+
+void Stats::writeJson(std::ostream& out) const {
+  const auto writePhases = [&out](const std::array<double, phaseCount>& phases) {
+    out << '{';
+    for (int phase = 0; phase < phaseCount; ++phase) {
+      out << (phase ? "," : "") << '"' << phaseName(static_cast<Phase>(phase)) << "\":" << phases[phase];
+    }
+    out << '}';
+  };
+
+  out << "{\"totalSeconds\":" << totalSeconds << ",\"bytesIn\":" << bytesIn << ",\"bytesOut\":" << bytesOut
+      << ",\"allocations\":";
+  if (countsAllocations()) out << allocations;
+  else out << "null"; // not counted in this build
+  out << ",\"composed\":" << (composed ? "true" : "false") << ",\"phases\":";
+  writePhases(seconds);
+  out << ",\"rounds\":[";
+  for (std::size_t i = 0; i < rounds.size(); ++i) {
+    out << (i ? "," : "") << "{\"gridSize\":" << rounds[i].gridSize << ",\"inputLength\":" << rounds[i].inputLength
+        << ",\"outputLength\":" << rounds[i].outputLength << ",\"phases\":";
+    writePhases(rounds[i].seconds);
+    out << '}';
+  }
+  out << "]}";
+}
+
+bool Stats::countsAllocations() {
+#ifdef DIAMOND_COUNT_ALLOCATIONS
+  return true;
+#else
+  return false;
+#endif
+}
+
+std::uint64_t Stats::allocationsSoFar() {
+#ifdef DIAMOND_COUNT_ALLOCATIONS
+  return allocationCount;
+#else
+  return 0;
+#endif
+}
+
+Stats::Call::Call(Stats* stats, const std::uint64_t bytesIn) : stats(stats && !stats->inCall ? stats : nullptr) {
+  if (!this->stats) return;
+  this->stats->clear();
+  this->stats->inCall = true;
+  this->stats->bytesIn = bytesIn;
+  allocationsBefore = allocationsSoFar();
+  start = std::chrono::steady_clock::now();
+}
+
+Stats::Call::~Call() {
+  if (!stats) return;
+  stats->totalSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  stats->allocations = allocationsSoFar() - allocationsBefore;
+  stats->inCall = false;
+}
@@ -0,0 +1,85 @@
+/*
+ Stats records where one engine call spent its time: per round and per phase timings,
+ the grid size of every round, bytes in and out and heap allocations.
+ nothing is collected unless a Stats object is attached (Encryptor::setStats, Decryptor::setStats),
+ without one every measuring point is a single null check.
+ a Stats object describes the last call only and must not be shared by calls running at the same time.
+ */
+
+#ifndef STATS_HPP
+#define STATS_HPP
+#include <array> // seconds per phase
+#include <chrono> // timers
+#include <cstdint> // byte and allocation counts
+#include <ostream> // JSON output
+#include <vector> // rounds
+
+struct Stats {
+  enum class Phase { Prepare, PathBuild, Fill, Pad, Serialize, Ingest, Extract, Trim };
+  static constexpr int phaseCount = 8;
+  static const char* phaseName(Phase phase);
+
+  struct Round {
+    int gridSize = 0;
+    std::uint64_t inputLength = 0;
+    std::uint64_t outputLength = 0;
+    std::array<double, phaseCount> seconds{}; // zero when the rounds ran as one composed pass
+  };
+
+  std::vector<Round> rounds; // in processing order
+  std::array<double, phaseCount> seconds{}; // whole call per phase, rounds included
+  double totalSeconds = 0;
+  bool composed = false; // all rounds ran as one pass (ComposedPlan), their time is only in seconds
+  std::uint64_t bytesIn = 0;
+  std::uint64_t bytesOut = 0;
+  std::uint64_t allocations = 0; // on the calling thread, only counted in builds with DIAMOND_COUNT_ALLOCATIONS
+
+  void clear();
+  [[nodiscard]] std::vector<int> gridSizes() const; // grid of every round, in processing order
+  void beginRound(int gridSize, std::uint64_t inputLength);
+  void endRound(std::uint64_t outputLength);
+  void add(Phase phase, double elapsed); // to the whole call and to the latest round (trimming belongs to the round before it)
+  void writeJson(std::ostream& out) const; // one line
+
+  [[nodiscard]] static bool countsAllocations(); // whether this build counts heap allocations
+  [[nodiscard]] static std::uint64_t allocationsSoFar(); // heap allocations made by this thread so far
+
+  // adds the time until the end of its scope to a phase, does nothing when stats is nullptr
+  class Timer {
+  public:
+    Timer(Stats* stats, const Phase phase) : stats(stats), phase(phase) {
+      if (stats) start = std::chrono::steady_clock::now();
+    }
+    ~Timer() {
+      if (stats) stats->add(phase, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    Timer(const Timer&) = delete;
+    Timer& operator=(const Timer&) = delete;
+
+  private:
+    Stats* stats;
+    Phase phase;
+    std::chrono::steady_clock::time_point start;
+  };
+
+  // brackets one public engine call: clears the stats, then records total time and allocations at the end.
+  // a call made from inside another one (encryptFile falling back to encrypt) leaves them to the outer one
+  class Call {
+  public:
+    Call(Stats* stats, std::uint64_t bytesIn);
+    ~Call();
+    void setOutput(std::uint64_t bytesOut) const { if (stats) stats->bytesOut = bytesOut; }
+    Call(const Call&) = delete;
+    Call& operator=(const Call&) = delete;
+
+  private:
+    Stats* stats; // nullptr when off or nested
+    std::chrono::steady_clock::time_point start;
+    std::uint64_t allocationsBefore = 0;
+  };
+
+private:
+  bool inCall = false;
+};
+
+#endif //STATS_HPP
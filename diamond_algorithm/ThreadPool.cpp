@@ -0,0 +1,95 @@
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <exception>
+
+ThreadPool::ThreadPool(unsigned threads) {
+  if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+  for (unsigned i = 0; i <= threads; ++i) queues.push_back(std::make_unique<Queue>());
+  for (unsigned i = 0; i < threads; ++i) workers.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard lock(sleepMutex);
+    stopping = true;
+  }
+  wake.notify_all();
+  for (auto& worker : workers) worker.join();
+}
+
+bool ThreadPool::runOne(const std::size_t self) {
+  std::function<void()> job;
+  {
+    Queue& own = *queues[self];
+    std::lock_guard lock(own.mutex);
+    if (!own.jobs.empty()) {
+      job = std::move(own.jobs.back()); // newest first, it is still warm in this core's cache
+      own.jobs.pop_back();
+    }
+  }
+  for (std::size_t offset = 1; !job && offset < queues.size(); ++offset) {
+    Queue& victim = *queues[(self + offset) % queues.size()];
+    std::lock_guard lock(victim.mutex);
+    if (!victim.jobs.empty()) {
+      job = std::move(victim.jobs.front()); // steal the oldest job
+      victim.jobs.pop_front();
+    }
+  }
+  if (!job) return false;
+  --queued;
+  job();
+  return true;
+}
+
+void ThreadPool::workerLoop(const std::size_t self) {
+  while (true) {
+    if (runOne(self)) continue;
+    std::unique_lock lock(sleepMutex);
+    wake.wait(lock, [this] { return stopping || queued > 0; });
+    if (stopping && queued == 0) return;
+  }
+}
+
+void ThreadPool::parallelFor(const std::size_t count, const std::function<void(std::size_t)>& task) {
+  if (count == 0) return;
+
+  struct Batch {
+    std::atomic<std::size_t> remaining;
+    std::mutex mutex;
+    std::condition_variable done;
+    std::exception_ptr error;
+  };
+  auto batch = std::make_shared<Batch>();
+  batch->remaining = count;
+
+  // deal the indices round-robin over the worker queues, idle workers steal the rest
+  for (std::size_t i = 0; i < count; ++i) {
+    Queue& queue = *queues[i % workers.size()];
+    std::lock_guard lock(queue.mutex);
+    queue.jobs.emplace_back([batch, &task, i] {
+      try {
+        task(i);
+      } catch (...) {
+        std::lock_guard errorLock(batch->mutex);
+        if (!batch->error) batch->error = std::current_exception();
+      }
+      if (--batch->remaining == 0) {
+        std::lock_guard doneLock(batch->mutex);
+        batch->done.notify_all();
+      }
+    });
+    ++queued;
+  }
+  {
+    std::lock_guard lock(sleepMutex);
+  }
+  wake.notify_all();
+
+  // the calling thread helps instead of just waiting
+  const std::size_t self = queues.size() - 1;
+  while (batch->remaining > 0 && runOne(self)) {}
+
+  std::unique_lock lock(batch->mutex);
+  batch->done.wait(lock, [&batch] { return batch->remaining == 0; });
+  if (batch->error) std::rethrow_exception(batch->error);
+}
@@ -0,0 +1,49 @@
+/*
+ ThreadPool is a small work-stealing pool for independent jobs (blocks, batches of messages).
+ every worker owns a deque: it takes work from the back of its own deque and, when that
+ runs dry, steals from the front of the others. parallelFor hands out indices and returns
+ once all of them ran, so callers write results by index and keep input order.
+ */
+
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+  explicit ThreadPool(unsigned threads = 0); // 0 = one worker per hardware thread
+  ~ThreadPool();
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  void parallelFor(std::size_t count, const std::function<void(std::size_t)>& task);
+    // runs task(0) .. task(count - 1) on the workers and the calling thread, and waits for all of them.
+    // the first exception thrown by a task is rethrown here once the others have finished.
+  [[nodiscard]] unsigned getThreadCount() const { return static_cast<unsigned>(workers.size()); }
+
+private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> jobs;
+  };
+
+  bool runOne(std::size_t self); // runs one job from our own queue or a stolen one, false if all were empty
+  void workerLoop(std::size_t self);
+
+  std::vector<std::unique_ptr<Queue>> queues; // one per worker, plus one for outside callers
+  std::vector<std::thread> workers;
+  std::atomic<std::size_t> queued{0};
+  std::mutex sleepMutex;
+  std::condition_variable wake;
+  bool stopping = false;
+};
+
+#endif //THREADPOOL_HPP
@@ -0,0 +1,130 @@
+#include "Trace.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+  // fields are relaxed atomics so the writer thread and writeJson never race, ordering comes from written
+  struct Slot {
+    std::atomic<const char*> name{nullptr};
+    std::atomic<std::uint64_t> start{0};
+    std::atomic<std::uint64_t> duration{0};
+  };
+
+  // one thread writes, any thread reads. the slot of span i is i % size. claimed moves before a slot is
+  // overwritten and written after it is complete, so a reader can tell which of the spans it copied are whole
+  struct ThreadBuffer {
+    explicit ThreadBuffer(const int thread) : thread(thread), slots(std::make_unique<Slot[]>(Trace::bufferEvents)) {}
+    const int thread;
+    const std::unique_ptr<Slot[]> slots;
+    std::atomic<std::uint64_t> claimed{0};
+    std::atomic<std::uint64_t> written{0};
+  };
+
+  struct RecordedSpan {
+    const char* name;
+    std::uint64_t start;
+    std::uint64_t duration;
+  };
+
+  // every buffer ever created, kept after its thread ends so its spans can still be written
+  struct Registry {
+    std::mutex mutex; // only taken when a thread records its first span and by writeJson
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    int nextThread = 1;
+  };
+
+  Registry& registry() {
+    static Registry instance;
+    return instance;
+  }
+
+  ThreadBuffer& localBuffer() {
+    thread_local const std::shared_ptr<ThreadBuffer> buffer = [] {
+      Registry& shared = registry();
+      const std::lock_guard lock(shared.mutex);
+      shared.buffers.push_back(std::make_shared<ThreadBuffer>(shared.nextThread++));
+      return shared.buffers.back();
+    }();
+    return *buffer;
+  }
+
+  // the spans still in a buffer, oldest first. spans the writer may have overwritten while they were copied are dropped
+  std::vector<RecordedSpan> snapshot(const ThreadBuffer& buffer) {
+    constexpr std::uint64_t capacity = Trace::bufferEvents;
+    const std::uint64_t end = buffer.written.load(std::memory_order_acquire);
+    std::vector<RecordedSpan> spans;
+    spans.reserve(end < capacity ? end : capacity);
+    for (std::uint64_t i = end < capacity ? 0 : end - capacity; i < end; ++i) {
+      const Slot& slot = buffer.slots[i % capacity];
+      spans.push_back({slot.name.load(std::memory_order_relaxed), slot.start.load(std::memory_order_relaxed),
+                       slot.duration.load(std::memory_order_relaxed)});
+    }
+    std::atomic_thread_fence(std::memory_order_acquire); // pairs with the fence in record: a changed slot shows in claimed
+    const std::uint64_t after = buffer.claimed.load(std::memory_order_relaxed);
+    if (const std::uint64_t first = end < capacity ? 0 : end - capacity; after > capacity && after - capacity > first) {
+      const std::uint64_t overwritten = std::min<std::uint64_t>(after - capacity - first, spans.size());
+      spans.erase(spans.begin(), spans.begin() + static_cast<std::ptrdiff_t>(overwritten));
+    }
+    return spans;
+  }
+
+  void writeEscaped(std::ostream& out, const char* text) {
+    for (; *text; ++text) {
+      if (*text == '"' || *text == '\\') out << '\\';
+      out << *text;
+    }
+  }
+}
+
+std::uint64_t Trace::now() {
+  static const auto epoch = std::chrono::steady_clock::now();
+  return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count());
+}
+
+void Trace::record(const char* name, const std::uint64_t start, const std::uint64_t duration) {
+  ThreadBuffer& buffer = localBuffer();
+  const std::uint64_t index = buffer.written.load(std::memory_order_relaxed); // only this thread writes it
+  buffer.claimed.store(index + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release); // the claim is visible before any of the new slot
+  Slot& slot = buffer.slots[index % bufferEvents];
+  slot.name.store(name, std::memory_order_relaxed);
+  slot.start.store(start, std::memory_order_relaxed);
+  slot.duration.store(duration, std::memory_order_relaxed);
+  buffer.written.store(index + 1, std::memory_order_release); // publishes the slot
+}
+
+void Trace::writeJson(std::ostream& out) {
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  {
+    const std::lock_guard lock(registry().mutex);
+    buffers = registry().buffers;
+  }
+
+  // complete events ("ph":"X"), timestamps and durations in microseconds
+  out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  bool first = true;
+  for (const auto& buffer : buffers) {
+    for (const RecordedSpan& span : snapshot(*buffer)) {
+      out << (first ? "\n" : ",\n") << "{\"name\":\"";
+      writeEscaped(out, span.name);
+      out << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->thread << ",\"ts\":" << static_cast<double>(span.start) / 1000.0
+          << ",\"dur\":" << static_cast<double>(span.duration) / 1000.0 << '}';
+      first = false;
+    }
+  }
+  out << "\n]}\n";
+}
+
+void Trace::writeFile(const std::string& path) {
+  std::ofstream file(path, std::ios::binary);
+  if (!file) throw std::runtime_error("cannot open " + path + " for writing");
+  file.precision(15); // microsecond timestamps keep their nanoseconds
+  writeJson(file);
+  if (!file.flush()) throw std::runtime_error("cannot write " + path);
+}
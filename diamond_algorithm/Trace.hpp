@@ -0,0 +1,55 @@
+/*
+ Trace records scoped spans of the engine and writes them as Chrome trace-event JSON
+ (chrome://tracing, ui.perfetto.dev). every thread writes into its own ring buffer without locks,
+ the newest bufferEvents spans per thread are kept, and writeJson can run while threads are tracing.
+ spans only exist in builds with DIAMOND_ENABLE_TRACING (see CMakeLists.txt), otherwise
+ DIAMOND_TRACE_SCOPE expands to nothing and writeJson writes an empty trace.
+ */
+
+#ifndef TRACE_HPP
+#define TRACE_HPP
+#include <cstddef> // buffer size
+#include <cstdint> // nanosecond timestamps
+#include <ostream> // JSON output
+#include <string> // file path
+
+class Trace {
+public:
+#ifdef DIAMOND_TRACING
+  static constexpr bool enabled = true;
+#else
+  static constexpr bool enabled = false;
+#endif
+  static constexpr std::size_t bufferEvents = std::size_t{1} << 16; // per thread, a power of two
+
+  static std::uint64_t now(); // nanoseconds since the first call
+  static void record(const char* name, std::uint64_t start, std::uint64_t duration);
+    // adds a finished span to the calling thread's buffer, overwriting its oldest span when full.
+    // name has to outlive the trace (a string literal)
+
+  static void writeJson(std::ostream& out); // every thread's spans as one trace-event document
+  static void writeFile(const std::string& path); // same, throws std::runtime_error when the file can't be written
+
+  // records the time from construction to the end of its scope
+  class Span {
+  public:
+    explicit Span(const char* name) : name(name), start(now()) {}
+    ~Span() { record(name, start, now() - start); }
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+  private:
+    const char* name;
+    std::uint64_t start;
+  };
+};
+
+#ifdef DIAMOND_TRACING
+#define DIAMOND_TRACE_JOIN_(a, b) a##b
+#define DIAMOND_TRACE_JOIN(a, b) DIAMOND_TRACE_JOIN_(a, b)
+#define DIAMOND_TRACE_SCOPE(name) const Trace::Span DIAMOND_TRACE_JOIN(traceSpan, __LINE__)(name)
+#else
+#define DIAMOND_TRACE_SCOPE(name) static_cast<void>(0)
+#endif
+
+#endif //TRACE_HPP
@@ -1,6 +1,11 @@
+#include "controller/CommandLine.hpp"
 #include "controller/Interface.hpp"
 
-int main() {
+int main(const int argc, char* argv[]) {
+    if (argc > 1) {
+        CommandLine cli(argc, argv); // headless mode, the menus are never built
+        return cli.run();
+    }
     Interface program;
     program.run();
     return 0;